@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../PocketWalker/PokeWalker/PokeWalker.h"
+#include "../PocketWalker/H8/Runner/LockstepRunner.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string romPath;
+        std::string eepromPath = "eeprom.bin";
+        size_t lanes = LockstepRunner::LANES;
+        uint64_t cycles = Cpu::TICKS;
+        uint64_t runCycles = Cpu::TICKS / 100;
+    };
+
+    void PrintUsage()
+    {
+        std::println("Usage: pocketwalker-lockstep-benchmark [options]");
+        std::println("  --lanes <n>       Instances run side by side, up to {}.", LockstepRunner::LANES);
+        std::println("  --cycles <n>      Cpu cycles every instance runs.");
+        std::println("  --run-cycles <n>  Cycles per call into the runners.");
+        std::println("  --rom <path>      Runs this rom instead of the built in kernel.");
+        std::println("  --eeprom <path>   Eeprom for the rom, every lane gets its own copy.");
+    }
+
+    bool ParseArguments(const int argc, char* argv[], Options& options)
+    {
+        for (int index = 1; index < argc; index++)
+        {
+            const std::string_view argument = argv[index];
+
+            const auto value = [&]() -> const char*
+            {
+                if (index + 1 >= argc)
+                    throw std::runtime_error(std::format("Missing value for {}", argument));
+
+                return argv[++index];
+            };
+
+            if (argument == "--lanes")
+                options.lanes = std::clamp<size_t>(std::stoull(value()), 1, LockstepRunner::LANES);
+            else if (argument == "--cycles")
+                options.cycles = std::stoull(value());
+            else if (argument == "--run-cycles")
+                options.runCycles = std::max<uint64_t>(std::stoull(value()), 1);
+            else if (argument == "--rom")
+                options.romPath = value();
+            else if (argument == "--eeprom")
+                options.eepromPath = value();
+            else if (argument == "--help" || argument == "-h")
+                return false;
+            else
+                throw std::runtime_error(std::format("Unknown option {}", argument));
+        }
+
+        return true;
+    }
+
+    // a loop over registers and plain ram, the seed at SEED_ADDRESS makes the lanes disagree on one branch now and then
+    constexpr uint16_t KERNEL_START = 0x0100;
+    constexpr uint16_t SEED_ADDRESS = 0xF780;
+    const std::vector<uint8_t> KERNEL = {
+        0x6B, 0x00, 0xF7, 0x80,             // MOV.W @0xF780, R0
+        0x7A, 0x01, 0x00, 0x00, 0x00, 0x00, // MOV.L #0, ER1
+        0x7A, 0x04, 0x00, 0x00, 0xF8, 0x00, // MOV.L #0xF800, ER4
+        // loop:
+        0x09, 0x01,                         // ADD.W R0, R1
+        0x15, 0x89,                         // XOR.B R0L, R1L
+        0x0D, 0x12,                         // MOV.W R1, R2
+        0x8A, 0x07,                         // ADD.B #7, R2L
+        0x19, 0x23,                         // SUB.W R2, R3
+        0x68, 0xCA,                         // MOV.B R2L, @ER4
+        0x68, 0x4D,                         // MOV.B @ER4, R5L
+        0x0B, 0x74,                         // INC.L #1, ER4
+        0x79, 0x64, 0xF8, 0xFF,             // AND.W #0xF8FF, R4
+        0x0C, 0x15,                         // MOV.B R1H, R5H
+        0xE5, 0xFF,                         // AND.B #0xFF, R5H
+        0x46, 0x02,                         // BNE +2
+        0x0B, 0x56,                         // INC.W #1, R6
+        0x1A, 0x0D,                         // DEC.B R5L
+        0x6B, 0x81, 0xF7, 0x82,             // MOV.W R1, @0xF782
+        0x40, 0xDC,                         // BRA loop
+    };
+
+    std::vector<uint8_t> ReadFile(const std::string& path)
+    {
+        std::vector<uint8_t> buffer(0x10000);
+        if (std::filesystem::exists(path))
+        {
+            std::ifstream file(path, std::ios::binary);
+            file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        }
+
+        return buffer;
+    }
+
+    // everything an instance keeps pointers into lives as long as it does
+    struct Instance
+    {
+        std::vector<uint8_t> memory;
+        std::vector<uint8_t> eeprom;
+        std::unique_ptr<H8300H> emulator;
+    };
+
+    std::vector<std::unique_ptr<Instance>> CreateInstances(const Options& options)
+    {
+        std::vector<std::unique_ptr<Instance>> instances;
+        for (size_t index = 0; index < options.lanes; index++)
+        {
+            auto instance = std::make_unique<Instance>();
+
+            if (options.romPath.empty())
+            {
+                instance->memory.resize(0x10000);
+                instance->memory[0] = KERNEL_START >> 8;
+                instance->memory[1] = KERNEL_START & 0xFF;
+                std::ranges::copy(KERNEL, instance->memory.begin() + KERNEL_START);
+
+                const uint16_t seed = static_cast<uint16_t>(0x1234 + index * 0x0B1D);
+                instance->memory[SEED_ADDRESS] = seed >> 8;
+                instance->memory[SEED_ADDRESS + 1] = seed & 0xFF;
+
+                instance->emulator = std::make_unique<H8300H>(instance->memory.data());
+            }
+            else
+            {
+                instance->memory = ReadFile(options.romPath);
+                instance->eeprom = ReadFile(options.eepromPath);
+                instance->emulator = std::make_unique<PokeWalker>(instance->memory.data(), instance->eeprom.data());
+            }
+
+            instances.push_back(std::move(instance));
+        }
+
+        return instances;
+    }
+
+    size_t CountInstructions(const std::vector<std::unique_ptr<Instance>>& instances)
+    {
+        size_t total = 0;
+        for (const auto& instance : instances)
+        {
+            total += instance->emulator->GetInstructionCount();
+        }
+
+        return total;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    try
+    {
+        if (!ParseArguments(argc, argv, options))
+        {
+            PrintUsage();
+            return 0;
+        }
+    }
+    catch (const std::exception& err)
+    {
+        std::println("{}", err.what());
+        PrintUsage();
+        return 1;
+    }
+
+    if (!options.romPath.empty() && !std::filesystem::exists(options.romPath))
+    {
+        std::println("Failed to find a rom with the name \"{}\"", options.romPath);
+        return 1;
+    }
+
+    // the same work twice, once as independent instances stepped one after another and once in lockstep
+    const auto scalar = CreateInstances(options);
+    const auto scalarStart = std::chrono::steady_clock::now();
+    for (const auto& instance : scalar)
+    {
+        instance->emulator->StartSliced();
+        for (uint64_t run = 0; run < options.cycles; run += options.runCycles)
+        {
+            instance->emulator->RunSlice(std::min(options.runCycles, options.cycles - run));
+        }
+    }
+    const std::chrono::duration<double> scalarTime = std::chrono::steady_clock::now() - scalarStart;
+
+    const auto lockstep = CreateInstances(options);
+    LockstepRunner runner;
+    for (const auto& instance : lockstep)
+    {
+        runner.Add(instance->emulator.get());
+    }
+
+    const auto lockstepStart = std::chrono::steady_clock::now();
+    for (uint64_t run = 0; run < options.cycles; run += options.runCycles)
+    {
+        runner.Run(std::min(options.runCycles, options.cycles - run));
+    }
+    const std::chrono::duration<double> lockstepTime = std::chrono::steady_clock::now() - lockstepStart;
+
+    // both have to end up in exactly the same place for the numbers to mean anything
+    size_t mismatches = 0;
+    for (size_t index = 0; index < options.lanes; index++)
+    {
+        const H8300H& expected = *scalar[index]->emulator;
+        const H8300H& actual = *lockstep[index]->emulator;
+
+        if (expected.GetCycles() != actual.GetCycles() || expected.GetInstructionCount() != actual.GetInstructionCount() ||
+            scalar[index]->memory != lockstep[index]->memory)
+        {
+            std::println("lane {} differs: cycles {} vs {}, instructions {} vs {}", index, expected.GetCycles(), actual.GetCycles(),
+                expected.GetInstructionCount(), actual.GetInstructionCount());
+            mismatches++;
+        }
+    }
+
+    const size_t scalarInstructions = CountInstructions(scalar);
+    const size_t lockstepInstructions = CountInstructions(lockstep);
+    const double scalarRate = scalarInstructions / scalarTime.count();
+    const double lockstepRate = lockstepInstructions / lockstepTime.count();
+    const LockstepStats& stats = runner.GetStats();
+
+    std::println("lanes={}", options.lanes);
+    std::println("scalar_instructions={}\nscalar_seconds={:.3f}\nscalar_mips={:.2f}", scalarInstructions, scalarTime.count(), scalarRate / 1e6);
+    std::println("lockstep_instructions={}\nlockstep_seconds={:.3f}\nlockstep_mips={:.2f}", lockstepInstructions, lockstepTime.count(), lockstepRate / 1e6);
+    std::println("speedup={:.2f}", lockstepRate / scalarRate);
+    std::println("shared_fraction={:.3f}", lockstepInstructions > 0 ? static_cast<double>(stats.lockstepInstructions) / lockstepInstructions : 0.0);
+    std::println("segments={}\ndivergences={}\nscalar_steps={}", stats.segments, stats.divergences, stats.scalarSteps);
+    std::println("state={}", mismatches == 0 ? "match" : "mismatch");
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,388 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../PocketWalker/PokeWalker/PokeWalker.h"
+#include "../PocketWalker/H8/Runner/FleetRunner.h"
+
+namespace
+{
+    // grey levels matching the desktop palette, lightest first
+    constexpr std::array<uint8_t, 4> PALETTE = {0xCC, 0x99, 0x66, 0x33};
+
+    std::vector<PokeWalker*> runningWalkers;
+
+    struct Options
+    {
+        std::string romPath = "rom.bin";
+        std::string eepromPath = "eeprom.bin";
+        std::string eepromOutPath;
+        std::string framesPath;
+        std::string statsPath;
+        std::string loadStatePath;
+        std::string saveStatePath;
+        uint64_t cycles = UINT64_MAX;
+        uint64_t frameInterval = 1;
+        size_t instances = 1;
+        size_t workers = std::max(std::thread::hardware_concurrency(), 1u);
+        uint64_t sliceCycles = FleetRunner::DEFAULT_SLICE_CYCLES;
+        bool isCorePinning = false;
+        bool isPaced = false;
+        bool isSaving = true;
+        bool isFastForward = false;
+        bool isBlockExecution = false;
+    };
+
+    void PrintUsage()
+    {
+        std::println("Usage: pocketwalker-headless [rom] [eeprom] [options]");
+        std::println("  --cycles <n>          Stops after n cpu cycles.");
+        std::println("  --seconds <n>         Stops after n seconds of emulated time.");
+        std::println("  --paced               Holds emulation to real time instead of running unthrottled.");
+        std::println("  --fast-forward        Skips sleeps and polling loops up to the next event.");
+        std::println("  --blocks              Runs cached blocks and recompiled code instead of single steps.");
+        std::println("  --eeprom-out <path>   Writes the eeprom here instead of over the input.");
+        std::println("  --no-save             Disables eeprom saving.");
+        std::println("  --frames <directory>  Writes lcd frames as pgm images.");
+        std::println("  --frame-interval <n>  Only writes every nth frame.");
+        std::println("  --stats <path>        Writes run statistics here as well as to the console.");
+        std::println("  --load-state <path>   Starts every walker from this save state instead of a cold boot.");
+        std::println("  --save-state <path>   Writes a save state of each walker here once the run ends.");
+        std::println("  --instances <n>       Runs n walkers from the same rom and eeprom on a pool of workers.");
+        std::println("  --workers <n>         Worker threads for more than one instance, one per core by default.");
+        std::println("  --slice-cycles <n>    Cycles an instance runs before its worker moves on.");
+        std::println("  --pin-cores           Pins each worker thread to its own core.");
+    }
+
+    bool ParseArguments(const int argc, char* argv[], Options& options)
+    {
+        size_t positional = 0;
+        for (int index = 1; index < argc; index++)
+        {
+            const std::string_view argument = argv[index];
+
+            const auto value = [&]() -> const char*
+            {
+                if (index + 1 >= argc)
+                    throw std::runtime_error(std::format("Missing value for {}", argument));
+
+                return argv[++index];
+            };
+
+            if (argument == "--cycles")
+                options.cycles = std::stoull(value());
+            else if (argument == "--seconds")
+                options.cycles = static_cast<uint64_t>(std::stod(value()) * Cpu::TICKS);
+            else if (argument == "--paced")
+                options.isPaced = true;
+            else if (argument == "--fast-forward")
+                options.isFastForward = true;
+            else if (argument == "--blocks")
+                options.isBlockExecution = true;
+            else if (argument == "--eeprom-out")
+                options.eepromOutPath = value();
+            else if (argument == "--no-save")
+                options.isSaving = false;
+            else if (argument == "--frames")
+                options.framesPath = value();
+            else if (argument == "--frame-interval")
+                options.frameInterval = std::max<uint64_t>(std::stoull(value()), 1);
+            else if (argument == "--stats")
+                options.statsPath = value();
+            else if (argument == "--load-state")
+                options.loadStatePath = value();
+            else if (argument == "--save-state")
+                options.saveStatePath = value();
+            else if (argument == "--instances")
+                options.instances = std::max<size_t>(std::stoull(value()), 1);
+            else if (argument == "--workers")
+                options.workers = std::max<size_t>(std::stoull(value()), 1);
+            else if (argument == "--slice-cycles")
+                options.sliceCycles = std::max<uint64_t>(std::stoull(value()), 1);
+            else if (argument == "--pin-cores")
+                options.isCorePinning = true;
+            else if (argument == "--help" || argument == "-h")
+                return false;
+            else if (argument.starts_with("--"))
+                throw std::runtime_error(std::format("Unknown option {}", argument));
+            else
+            {
+                // rom first then eeprom, the same as the desktop build
+                switch (positional++)
+                {
+                case 0:
+                    options.romPath = argument;
+                    break;
+                case 1:
+                    options.eepromPath = argument;
+                    break;
+                default:
+                    throw std::runtime_error(std::format("Unexpected argument {}", argument));
+                }
+            }
+        }
+
+        if (options.eepromOutPath.empty())
+        {
+            options.eepromOutPath = options.eepromPath;
+        }
+
+        return true;
+    }
+
+    void WriteFrame(const std::filesystem::path& path, const uint8_t* data)
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << std::format("P5\n{} {}\n255\n", Lcd::WIDTH, Lcd::HEIGHT);
+
+        std::array<uint8_t, Lcd::WIDTH * Lcd::HEIGHT> pixels;
+        for (size_t index = 0; index < pixels.size(); index++)
+        {
+            pixels[index] = PALETTE[data[index] & 0b11];
+        }
+
+        file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+    }
+
+    // everything a walker keeps pointers into lives as long as it does
+    struct Walker
+    {
+        std::vector<uint8_t> rom;
+        std::vector<uint8_t> eeprom;
+        std::unique_ptr<PokeWalker> pokeWalker;
+        uint64_t frames = 0;
+
+        // where a loaded save state left off, the run is counted from here
+        uint64_t startCycles = 0;
+        size_t startInstructions = 0;
+    };
+
+    std::unique_ptr<Walker> CreateWalker(const Options& options, const std::vector<uint8_t>& rom, const std::vector<uint8_t>& eeprom, const std::filesystem::path& framesPath)
+    {
+        auto walker = std::make_unique<Walker>(rom, eeprom);
+        walker->pokeWalker = std::make_unique<PokeWalker>(walker->rom.data(), walker->eeprom.data());
+
+        PokeWalker& pokeWalker = *walker->pokeWalker;
+        pokeWalker.SetThrottled(options.isPaced);
+        pokeWalker.SetCycleLimit(options.cycles);
+        pokeWalker.SetSleepFastForward(options.isFastForward);
+        pokeWalker.SetIdleLoopSkipping(options.isFastForward);
+        pokeWalker.SetBlockExecution(options.isBlockExecution);
+
+        pokeWalker.OnDraw([&options, framesPath, frames = &walker->frames](const LcdInformation lcd)
+        {
+            if (!framesPath.empty() && *frames % options.frameInterval == 0)
+            {
+                WriteFrame(framesPath / std::format("frame_{:08}.pgm", *frames), lcd.data);
+            }
+
+            (*frames)++;
+        });
+
+        if (!framesPath.empty())
+        {
+            std::filesystem::create_directories(framesPath);
+        }
+
+        return walker;
+    }
+
+    std::vector<uint8_t> ReadFile(const std::string& path)
+    {
+        std::vector<uint8_t> buffer(0x10000);
+        if (std::filesystem::exists(path))
+        {
+            std::ifstream file(path, std::ios::binary);
+            file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        }
+
+        return buffer;
+    }
+
+    std::vector<uint8_t> ReadState(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            throw std::runtime_error(std::format("Failed to open save state \"{}\"", path));
+
+        std::vector<uint8_t> buffer(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+
+        return buffer;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    try
+    {
+        if (!ParseArguments(argc, argv, options))
+        {
+            PrintUsage();
+            return 0;
+        }
+    }
+    catch (const std::exception& err)
+    {
+        std::println("{}", err.what());
+        PrintUsage();
+        return 1;
+    }
+
+    if (!std::filesystem::exists(options.romPath))
+    {
+        std::println("Failed to find a rom with the name \"{}\"", options.romPath);
+        return 1;
+    }
+
+    const std::vector<uint8_t> rom = ReadFile(options.romPath);
+    const std::vector<uint8_t> eeprom = ReadFile(options.eepromPath);
+
+    std::vector<uint8_t> state;
+    if (!options.loadStatePath.empty())
+    {
+        try
+        {
+            state = ReadState(options.loadStatePath);
+        }
+        catch (const std::exception& err)
+        {
+            std::println("{}", err.what());
+            return 1;
+        }
+    }
+
+    // a single walker runs on this thread, a fleet shares the worker pool
+    std::vector<std::unique_ptr<Walker>> walkers;
+    for (size_t index = 0; index < options.instances; index++)
+    {
+        std::filesystem::path framesPath = options.framesPath;
+        if (!framesPath.empty() && options.instances > 1)
+        {
+            framesPath /= std::to_string(index);
+        }
+
+        walkers.push_back(CreateWalker(options, rom, eeprom, framesPath));
+        runningWalkers.push_back(walkers.back()->pokeWalker.get());
+
+        if (!state.empty())
+        {
+            try
+            {
+                PokeWalker& pokeWalker = *walkers.back()->pokeWalker;
+                pokeWalker.LoadState(state);
+
+                walkers.back()->startCycles = pokeWalker.GetCycles();
+                walkers.back()->startInstructions = pokeWalker.GetInstructionCount();
+                if (options.cycles != UINT64_MAX)
+                {
+                    pokeWalker.SetCycleLimit(pokeWalker.GetCycles() + options.cycles);
+                }
+            }
+            catch (const std::exception& err)
+            {
+                std::println("Failed to load save state: {}", err.what());
+                return 1;
+            }
+        }
+    }
+
+    // ctrl+c still saves the eeprom and reports what ran
+    const auto stopAll = [](int)
+    {
+        for (PokeWalker* pokeWalker : runningWalkers)
+        {
+            pokeWalker->Stop();
+        }
+    };
+    std::signal(SIGINT, stopAll);
+    std::signal(SIGTERM, stopAll);
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    FleetRunner runner(options.workers, options.sliceCycles);
+    if (options.instances == 1)
+    {
+        walkers.front()->pokeWalker->StartSync();
+    }
+    else
+    {
+        runner.SetPaced(options.isPaced);
+        runner.SetCorePinning(options.isCorePinning);
+        for (const auto& walker : walkers)
+        {
+            runner.Add(walker->pokeWalker.get());
+        }
+
+        runner.Start();
+        runner.Wait();
+        runner.Stop();
+    }
+
+    const std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - startTime;
+
+    std::string stats;
+    uint64_t totalCycles = 0;
+    size_t totalInstructions = 0;
+    uint64_t totalFrames = 0;
+    for (size_t index = 0; index < walkers.size(); index++)
+    {
+        const Walker& walker = *walkers[index];
+
+        if (options.isSaving)
+        {
+            const std::string path = options.instances > 1 ? std::format("{}.{}", options.eepromOutPath, index) : options.eepromOutPath;
+            std::ofstream eepromFileOut(path, std::ios::binary);
+            eepromFileOut.write(reinterpret_cast<const char*>(walker.pokeWalker->GetEepromBuffer()), walker.eeprom.size());
+        }
+
+        if (!options.saveStatePath.empty())
+        {
+            const std::string path = options.instances > 1 ? std::format("{}.{}", options.saveStatePath, index) : options.saveStatePath;
+            const std::vector<uint8_t> saved = walker.pokeWalker->SaveState();
+            std::ofstream stateFile(path, std::ios::binary);
+            stateFile.write(reinterpret_cast<const char*>(saved.data()), saved.size());
+        }
+
+        totalCycles += walker.pokeWalker->GetCycles() - walker.startCycles;
+        totalInstructions += walker.pokeWalker->GetInstructionCount() - walker.startInstructions;
+        totalFrames += walker.frames;
+
+        if (options.instances > 1)
+        {
+            const FleetInstance& instance = runner.GetInstance(index);
+            stats += std::format("instance={} cycles={} frames={} slices={} busy_seconds={:.3f}\n",
+                index, walker.pokeWalker->GetCycles(), walker.frames, instance.slices.load(), instance.busyNanoseconds / 1e9);
+        }
+    }
+
+    const double emulatedSeconds = static_cast<double>(totalCycles) / Cpu::TICKS;
+    stats += std::format(
+        "instances={}\ncycles={}\ninstructions={}\nframes={}\nemulated_seconds={:.3f}\nwall_seconds={:.3f}\nspeed={:.2f}\nsteals={}\n",
+        walkers.size(), totalCycles, totalInstructions, totalFrames, emulatedSeconds, wallTime.count(),
+        wallTime.count() > 0 ? emulatedSeconds / wallTime.count() : 0.0, runner.GetSteals());
+
+    std::print("{}", stats);
+
+    if (!options.statsPath.empty())
+    {
+        std::ofstream statsFile(options.statsPath);
+        statsFile << stats;
+    }
+
+    return 0;
+}
@@ -0,0 +1,256 @@
+#include "Recompiler.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+#include "../PocketWalker/H8/Cpu/Blocks/BlockCache.h"
+#include "../PocketWalker/H8/Cpu/Recompiled/RecompiledBackend.h"
+
+Recompiler::Recompiler(const std::vector<uint8_t>& rom) : buffer(0x10000 + 8), instructions(InstructionTable::Shared()), opcode(nullptr)
+{
+    std::copy_n(rom.begin(), std::min<size_t>(rom.size(), 0x10000), buffer.begin());
+    
+    hash = RecompiledBackend::Hash(buffer.data(), InstructionCache::CODE_END);
+}
+
+void Recompiler::Analyze()
+{
+    std::vector<uint16_t> pending;
+    for (uint16_t vector = 0; vector < VECTOR_END; vector += 2)
+    {
+        const uint16_t address = buffer[vector] << 8 | buffer[vector + 1];
+        if (address != 0x0000)
+        {
+            pending.push_back(address);
+        }
+    }
+
+    while (!pending.empty())
+    {
+        const uint16_t address = pending.back();
+        pending.pop_back();
+
+        // instructions are word aligned, anything else is data
+        if (address >= InstructionCache::CODE_END || address & 1 || visited.contains(address))
+            continue;
+
+        visited.insert(address);
+        Build(address, pending);
+    }
+
+    std::ranges::sort(blocks, {}, &RecompilerBlock::address);
+}
+
+void Recompiler::Build(const uint16_t address, std::vector<uint16_t>& pending)
+{
+    RecompilerBlock block = {};
+    block.address = address;
+
+    // same boundaries as BlockCache::Build so both backends agree on cycle counts
+    size_t cycles = 0;
+    bool fallthrough = true;
+    uint16_t current = address;
+    while (current < InstructionCache::CODE_END && cycles < BlockCache::MAX_BLOCK_CYCLES)
+    {
+        opcode.Load(current, &buffer[current]);
+        
+        const Instruction* instruction = instructions->Decode(&opcode);
+        if (instruction == nullptr)
+        {
+            fallthrough = false;
+            break;
+        }
+
+        RecompilerInstruction entry = {};
+        entry.instruction = instruction;
+        entry.address = current;
+        entry.nextAddress = current + instruction->bytes;
+        std::copy_n(&buffer[current], 8, entry.opcode);
+        block.instructions.push_back(entry);
+
+        cycles += instruction->cycles;
+        current = entry.nextAddress;
+
+        if (BlockCache::IsControlFlow(instruction))
+        {
+            const std::string& name = instruction->name;
+            if (name.contains(" d:") || name.ends_with("@aa:24"))
+            {
+                pending.push_back(BranchTarget(entry));
+            }
+
+            // JMP @ERn and returns are resolved at runtime by the interpreter
+            fallthrough = !(name.starts_with("BRA") || name.starts_with("JMP") || name == "RTS" || name == "RTE");
+            break;
+        }
+    }
+
+    if (block.instructions.empty())
+        return;
+
+    block.end = current;
+    if (fallthrough)
+    {
+        pending.push_back(current);
+    }
+
+    blocks.push_back(block);
+}
+
+void Recompiler::Emit(std::ostream& stream, const std::string& runtimeInclude, const std::string& symbol) const
+{
+    stream << "// generated by PocketWalker.Recompiler, do not edit\n";
+    stream << std::format("#include \"{}\"\n\n", runtimeInclude);
+    stream << "namespace\n{\n";
+
+    for (const RecompilerBlock& block : blocks)
+    {
+        stream << std::format("    size_t Block_{:04X}(Cpu* cpu)\n    {{\n", block.address);
+        stream << "        [[maybe_unused]] Registers* registers = cpu->registers;\n";
+        stream << "        [[maybe_unused]] Flags* flags = cpu->flags;\n";
+        stream << "        [[maybe_unused]] const uint32_t generation = cpu->instructionCache->generation;\n";
+
+        size_t cycles = 0;
+        size_t count = 0;
+        bool exited = false;
+        for (const RecompilerInstruction& instruction : block.instructions)
+        {
+            cycles += instruction.instruction->cycles;
+            count++;
+            
+            stream << std::format("\n        // {:04X}: {}\n", instruction.address, instruction.instruction->name);
+
+            const std::string code = EmitInstruction(instruction);
+            if (BlockCache::IsControlFlow(instruction.instruction))
+            {
+                if (code.empty())
+                {
+                    stream << std::format("        RecompiledRuntime::Interpret(cpu, 0x{:04X}, 0x{:04X}, generation);\n", instruction.address, instruction.nextAddress);
+                }
+                else
+                {
+                    stream << code;
+                }
+                
+                stream << std::format("        return RecompiledRuntime::Exit(cpu, {}, {});\n", cycles, count);
+                exited = true;
+            }
+            else if (code.empty())
+            {
+                stream << std::format("        if (!RecompiledRuntime::Interpret(cpu, 0x{:04X}, 0x{:04X}, generation))\n", instruction.address, instruction.nextAddress);
+                stream << std::format("            return RecompiledRuntime::Exit(cpu, {}, {});\n", cycles, count);
+            }
+            else
+            {
+                stream << code;
+            }
+        }
+
+        if (!exited)
+        {
+            stream << std::format("\n        registers->pc = 0x{:04X};\n", block.end);
+            stream << std::format("        return RecompiledRuntime::Exit(cpu, {}, {});\n", cycles, count);
+        }
+        
+        stream << "    }\n\n";
+    }
+
+    stream << "    const RecompiledBlockEntry BLOCKS[] =\n    {\n";
+    for (const RecompilerBlock& block : blocks)
+    {
+        stream << std::format("        {{ 0x{:04X}, 0x{:04X}, Block_{:04X} }},\n", block.address, block.end, block.address);
+    }
+    stream << "    };\n}\n\n";
+
+    stream << std::format("extern const RecompiledRom {} = {{ 0x{:08X}, BLOCKS, std::size(BLOCKS) }};\n", symbol, hash);
+}
+
+std::string Recompiler::EmitInstruction(const RecompilerInstruction& instruction) const
+{
+    const std::string& name = instruction.instruction->name;
+    const uint8_t* bytes = instruction.opcode;
+    
+    const uint8_t aL = bytes[0] & 0xF;
+    const uint8_t bH = bytes[1] >> 4;
+    const uint8_t bL = bytes[1] & 0xF;
+    const uint16_t cd = bytes[2] << 8 | bytes[3];
+    const uint32_t cdef = static_cast<uint32_t>(cd) << 16 | bytes[4] << 8 | bytes[5];
+
+    // only simple register ops are inlined, the rest go through the interpreter handlers
+    if (name == "NOP")
+        return "        (void)0;\n";
+
+    if (name == "MOV.B #xx:8, Rd")
+        return std::format("        *registers->Register8(0x{:X}) = 0x{:02X};\n        flags->Mov<uint8_t>(0x{:02X});\n", aL, bytes[1], bytes[1]);
+
+    if (name == "MOV.W #xx:16, Rd")
+        return std::format("        *registers->Register16(0x{:X}) = 0x{:04X};\n        flags->Mov<uint16_t>(0x{:04X});\n", bL, cd, cd);
+
+    if (name == "MOV.L #xx:32, ERd")
+        return std::format("        *registers->Register32(0x{:X}) = 0x{:08X};\n        flags->Mov<uint32_t>(0x{:08X});\n", bL, cdef, cdef);
+
+    if (name == "MOV.B Rs, Rd")
+        return std::format("        *registers->Register8(0x{:X}) = *registers->Register8(0x{:X});\n        flags->Mov<uint8_t>(*registers->Register8(0x{:X}));\n", bL, bH, bL);
+
+    if (name == "ADD.B #xx:8, Rd")
+        return std::format("        flags->Add<uint8_t>(*registers->Register8(0x{:X}), 0x{:02X});\n        *registers->Register8(0x{:X}) += 0x{:02X};\n", aL, bytes[1], aL, bytes[1]);
+
+    if (name == "CMP.B #xx:8, Rd")
+        return std::format("        flags->Sub<uint8_t>(*registers->Register8(0x{:X}), 0x{:02X});\n", aL, bytes[1]);
+
+    if (name == "CMP.B Rs, Rd")
+        return std::format("        flags->Sub<uint8_t>(*registers->Register8(0x{:X}), *registers->Register8(0x{:X}));\n", bL, bH);
+
+    if (name == "CMP.W #xx:16, Rd")
+        return std::format("        flags->Sub<uint16_t>(*registers->Register16(0x{:X}), 0x{:04X});\n", bL, cd);
+
+    if (name == "JMP @aa:24" || (name.starts_with('B') && !name.starts_with("BSR") && name.contains(" d:")))
+        return EmitBranch(instruction, BranchTarget(instruction));
+
+    return "";
+}
+
+std::string Recompiler::EmitBranch(const RecompilerInstruction& instruction, const uint16_t target)
+{
+    const std::string& name = instruction.instruction->name;
+    const std::string condition = BranchCondition(name.substr(0, name.find(' ')));
+    
+    if (condition.empty())
+        return std::format("        registers->pc = 0x{:04X};\n", target);
+
+    return std::format("        flags->Resolve();\n        registers->pc = {} ? 0x{:04X} : 0x{:04X};\n", condition, target, instruction.nextAddress);
+}
+
+std::string Recompiler::BranchCondition(const std::string& mnemonic)
+{
+    if (mnemonic == "BHI") return "!(flags->carry || flags->zero)";
+    if (mnemonic == "BLS") return "(flags->carry || flags->zero)";
+    if (mnemonic == "BCC") return "!flags->carry";
+    if (mnemonic == "BCS") return "flags->carry";
+    if (mnemonic == "BNE") return "!flags->zero";
+    if (mnemonic == "BEQ") return "flags->zero";
+    if (mnemonic == "BPL") return "!flags->negative";
+    if (mnemonic == "BMI") return "flags->negative";
+    if (mnemonic == "BGE") return "(flags->negative == flags->overflow)";
+    if (mnemonic == "BLT") return "(flags->negative != flags->overflow)";
+    if (mnemonic == "BGT") return "!(flags->zero || (flags->negative != flags->overflow))";
+    if (mnemonic == "BLE") return "(flags->zero || (flags->negative != flags->overflow))";
+    if (mnemonic == "BRA" || mnemonic == "JMP") return "";
+
+    throw std::runtime_error(std::format("No branch condition for {}.", mnemonic));
+}
+
+uint16_t Recompiler::BranchTarget(const RecompilerInstruction& instruction)
+{
+    const uint8_t* bytes = instruction.opcode;
+    const std::string& name = instruction.instruction->name;
+
+    if (name.ends_with("@aa:24"))
+        return static_cast<uint16_t>(bytes[2] << 8 | bytes[3]);
+
+    if (name.ends_with("d:16"))
+        return instruction.nextAddress + static_cast<int16_t>(bytes[2] << 8 | bytes[3]);
+
+    return instruction.nextAddress + static_cast<int8_t>(bytes[1]);
+}
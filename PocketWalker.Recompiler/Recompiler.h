@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../PocketWalker/H8/Cpu/Components/Opcode.h"
+#include "../PocketWalker/H8/Cpu/Instructions/InstructionTable.h"
+
+struct RecompilerInstruction
+{
+    const Instruction* instruction;
+    uint16_t address;
+    uint16_t nextAddress;
+    uint8_t opcode[8];
+};
+
+struct RecompilerBlock
+{
+    uint16_t address;
+    uint16_t end;
+    std::vector<RecompilerInstruction> instructions;
+};
+
+// walks the rom from its vectors and call targets and writes every block out as c++
+class Recompiler
+{
+public:
+    Recompiler(const std::vector<uint8_t>& rom);
+
+    void Analyze();
+    void Emit(std::ostream& stream, const std::string& runtimeInclude, const std::string& symbol) const;
+
+    const std::vector<RecompilerBlock>& GetBlocks() const { return blocks; }
+    uint32_t GetHash() const { return hash; }
+
+    // vectors live in the first 0x56 bytes of the rom
+    static constexpr uint16_t VECTOR_END = 0x0056;
+
+private:
+    void Build(uint16_t address, std::vector<uint16_t>& pending);
+    
+    std::string EmitInstruction(const RecompilerInstruction& instruction) const;
+    static std::string EmitBranch(const RecompilerInstruction& instruction, uint16_t target);
+    static std::string BranchCondition(const std::string& mnemonic);
+    static uint16_t BranchTarget(const RecompilerInstruction& instruction);
+    
+    std::vector<uint8_t> buffer;
+    uint32_t hash;
+
+    InstructionTable* instructions;
+    Opcode opcode;
+
+    std::set<uint16_t> visited;
+    std::vector<RecompilerBlock> blocks;
+};
@@ -0,0 +1,73 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <print>
+#include <vector>
+
+#include "../external/argparse/include/argparse/argparse.hpp"
+
+#include "Recompiler.h"
+
+int main(int argc, char* argv[])
+{
+    argparse::ArgumentParser arguments("Pocket Walker Recompiler");
+
+    arguments.add_argument("rom")
+        .help("The path for your PokeWalker rom file.")
+        .default_value("rom.bin");
+
+    arguments.add_argument("output")
+        .help("The path for the generated c++ file.")
+        .default_value("RecompiledRom.cpp");
+
+    arguments.add_argument("--runtime-include")
+        .help("Include path of RecompiledRuntime.h as seen from the generated file.")
+        .default_value("PocketWalker/H8/Cpu/Recompiled/RecompiledRuntime.h");
+
+    arguments.add_argument("--symbol")
+        .help("Name of the generated RecompiledRom.")
+        .default_value("RECOMPILED_ROM");
+
+    try {
+        arguments.parse_args(argc, argv);
+    }
+    catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << arguments;
+        return 1;
+    }
+
+    const std::string romPath = arguments.get<std::string>("rom");
+    if (!std::filesystem::exists(romPath))
+    {
+        std::println("Failed to find a rom with the name \"{}\"", romPath);
+        return 1;
+    }
+
+    std::ifstream romFile(romPath, std::ios::binary);
+    const std::vector<uint8_t> rom((std::istreambuf_iterator(romFile)), std::istreambuf_iterator<char>());
+
+    Recompiler recompiler(rom);
+    recompiler.Analyze();
+
+    const std::string outputPath = arguments.get<std::string>("output");
+    std::ofstream output(outputPath);
+    if (!output)
+    {
+        std::println("Failed to open \"{}\" for writing", outputPath);
+        return 1;
+    }
+    
+    recompiler.Emit(output, arguments.get<std::string>("--runtime-include"), arguments.get<std::string>("--symbol"));
+
+    size_t instructionCount = 0;
+    for (const RecompilerBlock& block : recompiler.GetBlocks())
+    {
+        instructionCount += block.instructions.size();
+    }
+
+    std::println("Recompiled {} blocks ({} instructions) with rom hash {:08X} into \"{}\"",
+        recompiler.GetBlocks().size(), instructionCount, recompiler.GetHash(), outputPath);
+    
+    return 0;
+}
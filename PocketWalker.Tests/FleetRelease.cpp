@@ -0,0 +1,104 @@
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <print>
+#include <vector>
+
+#include "../PocketWalker/PokeWalker/PokeWalker.h"
+#include "../PocketWalker/H8/Runner/FleetRunner.h"
+
+// runs rounds of walkers through a fleet and destroys them, the heap has to end up where it was after the first round
+
+namespace
+{
+    // every allocation carries its size in front so the live total can be kept
+    constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+    std::atomic<int64_t> liveBytes = 0;
+
+    constexpr size_t INSTANCES = 16;
+    constexpr size_t ROUNDS = 4;
+    constexpr uint64_t CYCLES = Cpu::TICKS / 20;
+
+    // anything the first round leaves behind for good, like the shared instruction table, fits well inside this,
+    // a single walker that isn't released is far bigger
+    constexpr int64_t SLACK_BYTES = 16 * 1024;
+
+    void RunRound(const std::vector<uint8_t>& rom)
+    {
+        std::vector<std::vector<uint8_t>> buffers;
+        std::vector<std::unique_ptr<PokeWalker>> walkers;
+        FleetRunner runner(4, Cpu::TICKS / 100);
+
+        for (size_t index = 0; index < INSTANCES; index++)
+        {
+            buffers.emplace_back(rom);
+            buffers.emplace_back(Eeprom::SIZE);
+
+            auto walker = std::make_unique<PokeWalker>(buffers[buffers.size() - 2].data(), buffers.back().data());
+            walker->SetBlockExecution(index % 2 == 0);
+            walker->SetCycleLimit(CYCLES);
+            runner.Add(walker.get());
+            walkers.push_back(std::move(walker));
+        }
+
+        runner.Start();
+        runner.Wait();
+        runner.Stop();
+    }
+}
+
+void* operator new(const size_t size)
+{
+    auto* block = static_cast<uint8_t*>(std::malloc(size + HEADER_SIZE));
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    *reinterpret_cast<size_t*>(block) = size;
+    liveBytes += static_cast<int64_t>(size);
+    return block + HEADER_SIZE;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer == nullptr)
+        return;
+
+    auto* block = static_cast<uint8_t*>(pointer) - HEADER_SIZE;
+    liveBytes -= static_cast<int64_t>(*reinterpret_cast<size_t*>(block));
+    std::free(block);
+}
+
+void* operator new[](const size_t size) { return operator new(size); }
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { operator delete(pointer); }
+
+int main()
+{
+    // reset vector to 0x0100, which branches to itself
+    std::vector<uint8_t> rom(0x10000);
+    rom[0x0000] = 0x01;
+    rom[0x0001] = 0x00;
+    rom[0x0100] = 0x40;
+    rom[0x0101] = 0xFE;
+
+    RunRound(rom);
+    const int64_t baseline = liveBytes;
+
+    for (size_t round = 1; round < ROUNDS; round++)
+    {
+        RunRound(rom);
+    }
+
+    const int64_t leaked = liveBytes - baseline;
+    std::println("{} rounds of {} instances, {} bytes still allocated after the first", ROUNDS, INSTANCES, leaked);
+
+    if (leaked > SLACK_BYTES)
+    {
+        std::println("instances weren't released");
+        return 1;
+    }
+
+    return 0;
+}
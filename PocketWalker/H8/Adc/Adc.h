@@ -18,9 +18,10 @@ namespace AdcFlags
 class Adc : public Component
 {
 public:
-    Adc(Memory* ram) : ram(ram),
+    Adc(Memory* ram) :
         start(ram->CreateAccessor<uint8_t>(START_ADDR)),
-        result(ram->CreateAccessor<uint16_t>(RESULT_ADDR))
+        result(ram->CreateAccessor<uint16_t>(RESULT_ADDR)),
+        ram(ram)
     {
         ram->OnWrite(START_ADDR, [this](uint8_t, bool)
         {
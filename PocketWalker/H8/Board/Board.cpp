@@ -1,34 +1,110 @@
-
 #include <print>
 #include "Board.h"
 
+#include <cstring>
+
 #include "../Rtc/Rtc.h"
+#include "../../Utilities/StateStream.h"
 
 
-void Board::Tick(uint64_t cycles)
+void Board::SaveState(StateWriter& state) const
 {
-    if (cycles % ssu->clockRate == 0)
+    state.BeginSection(StateTag("RAM "));
+    state.WriteBytes(ram->buffer, RAM_SIZE);
+    state.EndSection();
+
+    state.BeginSection(StateTag("CPU "));
+    cpu->SaveState(state);
+    state.EndSection();
+
+    state.BeginSection(StateTag("SCHD"));
+    scheduler->SaveState(state);
+    state.EndSection();
+
+    for (const auto& [tag, component] : GetStateComponents())
     {
-        ssu->Tick();
+        state.BeginSection(tag);
+        component->SaveState(state);
+        state.EndSection();
     }
-    
-    if (cycles % (Cpu::TICKS / Timer::TICKS) == 0)
+}
+
+void Board::LoadState(StateReader& state)
+{
+    state.OpenSection(StateTag("RAM "));
+
+    // ram goes in without running handlers, the decoded code only has to go if the code itself differs
+    const bool isCodeChanged = std::memcmp(ram->buffer, state.Peek(RAM_SIZE), InstructionCache::CODE_END) != 0;
+    state.ReadChangedBytes(ram->buffer, RAM_SIZE);
+    state.CloseSection();
+
+    if (isCodeChanged)
     {
-        timer->Tick();
+        cpu->instructionCache->Clear();
+        cpu->blocks->Clear();
     }
 
-    if (cycles % (Cpu::TICKS / Sci3::TICKS) == 0 && timer->clockStop1 & TimerFlags::STANDBY_SCI3)
+    state.OpenSection(StateTag("CPU "));
+    cpu->LoadState(state);
+    state.CloseSection();
+
+    state.OpenSection(StateTag("SCHD"));
+    scheduler->LoadState(state);
+    state.CloseSection();
+
+    for (const auto& [tag, component] : GetStateComponents())
     {
-        sci3->Tick();
+        state.OpenSection(tag);
+        component->LoadState(state);
+        state.CloseSection();
     }
+}
+
+std::array<std::pair<uint32_t, Component*>, 5> Board::GetStateComponents() const
+{
+    return {{
+        {StateTag("SSU "), ssu},
+        {StateTag("SCI3"), sci3},
+        {StateTag("TMB1"), timer->b1},
+        {StateTag("TMW "), timer->w},
+        {StateTag("RTC "), rtc}
+    }};
+}
+
+void Board::ScheduleComponents()
+{
+    // ssu and the timers schedule themselves
+    scheduler->Schedule(Cpu::TICKS / Sci3::TICKS, [this]
+    {
+        if (timer->clockStop1 & TimerFlags::STANDBY_SCI3)
+        {
+            sci3->Tick();
+        }
+    }, [this]
+    {
+        return ~timer->clockStop1 & TimerFlags::STANDBY_SCI3 || sci3->IsIdle();
+    });
     
-    if (cycles % (Cpu::TICKS / Adc::TICKS) == 0 && timer->clockStop1 & TimerFlags::STANDBY_ADC)
+    // conversions finish as soon as they are started, ticking never changes anything
+    scheduler->Schedule(Cpu::TICKS / Adc::TICKS, [this]
     {
-        adc->Tick();
-    }
+        if (timer->clockStop1 & TimerFlags::STANDBY_ADC)
+        {
+            adc->Tick();
+        }
+    }, []
+    {
+        return true;
+    });
 
-    if (cycles % (Cpu::TICKS / Rtc::TICKS) == 0 && timer->clockStop1 & TimerFlags::STANDBY_RTC)
+    scheduler->Schedule(Cpu::TICKS / Rtc::TICKS, [this]
     {
-        rtc->Tick();
-    }
+        if (timer->clockStop1 & TimerFlags::STANDBY_RTC)
+        {
+            rtc->Tick();
+        }
+    }, [this]
+    {
+        return ~timer->clockStop1 & TimerFlags::STANDBY_RTC;
+    });
 }
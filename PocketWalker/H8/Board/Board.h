@@ -1,6 +1,9 @@
 #pragma once
+#include <array>
 #include <cstdint>
+#include <utility>
 
+#include "Scheduler.h"
 #include "../Cpu/Cpu.h"
 #include "../Memory/Memory.h"
 #include "../../PokeWalker/IO/Lcd/Lcd.h"
@@ -16,6 +19,8 @@ class Lcd;
 class Cpu;
 class Ssu;
 class Memory;
+class StateWriter;
+class StateReader;
 
 class Board
 {
@@ -24,18 +29,41 @@ public:
     {
         ram = new Memory(ramBuffer);
         ram->name = "Ram";
+
+        scheduler = new Scheduler();
         
         cpu = new Cpu(ram);
-        ssu = new Ssu(ram, cpu->interrupts, cpu->flags);
+        ssu = new Ssu(ram, cpu->interrupts, cpu->flags, scheduler);
         sci3 = new Sci3(ram);
         adc = new Adc(ram);
-        timer = new Timer(ram, cpu->interrupts);
+        timer = new Timer(ram, cpu->interrupts, scheduler);
         rtc = new Rtc(ram, cpu->interrupts);
 
+        ScheduleComponents();
     }
- 
-    void Tick(uint64_t cycles);
 
+    ~Board()
+    {
+        delete rtc;
+        delete timer;
+        delete adc;
+        delete sci3;
+        delete ssu;
+        delete cpu;
+        delete scheduler;
+        delete ram;
+    }
+
+    Board(const Board&) = delete;
+    Board& operator=(const Board&) = delete;
+
+    // ram, the cpu, the scheduler and every on-chip peripheral, each in its own section
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+
+    static constexpr size_t RAM_SIZE = 0x10000;
+
+    Scheduler* scheduler;
     Memory* ram;
     Cpu* cpu;
     Ssu* ssu;
@@ -43,4 +71,10 @@ public:
     Timer* timer;
     Rtc* rtc;
     Adc* adc;
+
+private:
+    void ScheduleComponents();
+
+    // peripherals that keep state outside ram, in the order their sections are written
+    std::array<std::pair<uint32_t, Component*>, 5> GetStateComponents() const;
 };
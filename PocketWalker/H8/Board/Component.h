@@ -1,9 +1,16 @@
 #pragma once
 
+class StateWriter;
+class StateReader;
+
 class Component
 {
 public:
     virtual ~Component() = default;
     
     virtual void Tick() { }
+
+    // state that lives outside ram, registers in ram go with the ram
+    virtual void SaveState(StateWriter&) const { }
+    virtual void LoadState(StateReader&) { }
 };
@@ -0,0 +1,193 @@
+#include "IdleLoopDetector.h"
+
+#include <cstring>
+
+#include "Scheduler.h"
+#include "../Cpu/Cpu.h"
+#include "../Memory/Memory.h"
+
+uint64_t IdleLoopDetector::Skip()
+{
+    if (loop == nullptr || cpu->registers->pc != head)
+        return 0;
+
+    const uint64_t now = scheduler->cycles;
+    const uint64_t lastArrival = arrivalCycle;
+    arrivalCycle = now;
+
+    // a full iteration without an interrupt in between, and nothing it did stuck
+    if (now - lastArrival != loop->cycles || !IsUnchanged())
+    {
+        cpu->flags->Resolve();
+        ccr = cpu->flags->ccr;
+        std::memcpy(registers.data(), cpu->registers->buffer, registers.size());
+
+        return 0;
+    }
+
+    if (loop->generation != cpu->instructionCache->generation)
+    {
+        loop = &Analyze(head);
+        if (!loop->isIdle)
+        {
+            loop = nullptr;
+            return 0;
+        }
+    }
+
+    // reads that run handlers can see values that change without an event, lazily counted timers for one,
+    // and watched reads have to be seen one by one
+    for (uint8_t index = 0; index < loop->readCount; index++)
+    {
+        const uint8_t reg = loop->readRegisters[index];
+        const uint16_t address = reg == NO_REGISTER ? loop->readAddresses[index] : *cpu->registers->Register32(reg) & 0xFFFF;
+        if (cpu->ram->HasReadHandler(address) || cpu->ram->HasReadWatch(address))
+            return 0;
+    }
+
+    for (uint16_t address = head; address < head + MAX_LOOP_BYTES; address++)
+    {
+        if (cpu->HasAddressHandler(address))
+            return 0;
+    }
+
+    // the iteration that crosses the next deadline still has to run for real
+    const uint64_t deadline = scheduler->nextDeadline;
+    if (deadline == UINT64_MAX)
+        return 0;
+
+    const uint64_t iterations = (deadline - 1 - now) / loop->cycles;
+    if (iterations == 0)
+        return 0;
+
+    const uint64_t skipped = iterations * loop->cycles;
+    scheduler->Advance(skipped);
+    cpu->instructionCount += iterations * loop->instructions;
+
+    loop->skips++;
+    loop->skippedCycles += skipped;
+
+    arrivalCycle = scheduler->cycles;
+    return skipped;
+}
+
+void IdleLoopDetector::Stepped(const uint16_t pc)
+{
+    // a jump a short way back is the closing branch of a possible loop
+    const uint16_t next = cpu->registers->pc;
+    if (next > pc || pc - next >= MAX_LOOP_BYTES || next == head)
+        return;
+
+    IdleLoop& candidate = Analyze(next);
+    loop = candidate.isIdle ? &candidate : nullptr;
+    head = next;
+    arrivalCycle = UINT64_MAX;
+}
+
+IdleLoop& IdleLoopDetector::Analyze(const uint16_t head)
+{
+    const uint32_t generation = cpu->instructionCache->generation;
+
+    const auto existing = loops.find(head);
+    if (existing != loops.end() && existing->second.generation == generation)
+        return existing->second;
+
+    IdleLoop& loop = loops[head];
+    loop.isIdle = false;
+    loop.generation = generation;
+    loop.instructions = 0;
+    loop.cycles = 0;
+    loop.readCount = 0;
+
+    // code outside the cache can change without the generation moving
+    if (head >= InstructionCache::CODE_END - MAX_LOOP_BYTES)
+        return loop;
+
+    const auto addRead = [&loop](const uint16_t address, const uint8_t reg)
+    {
+        if (loop.readCount == loop.readAddresses.size())
+            return false;
+
+        loop.readAddresses[loop.readCount] = address;
+        loop.readRegisters[loop.readCount] = reg;
+        loop.readCount++;
+
+        return true;
+    };
+
+    uint16_t address = head;
+    while (address < head + MAX_LOOP_BYTES)
+    {
+        const CachedInstruction* cached = cpu->instructionCache->Fetch(address, cpu->opcodes);
+        if (cached->instruction == nullptr)
+            return loop;
+
+        const uint8_t* opcode = cached->opcode;
+        const uint16_t next = address + cached->bytes;
+
+        loop.instructions++;
+        loop.cycles += cached->cycles;
+
+        // Bcc d:8 / d:16 closing the loop
+        if (opcode[0] >> 4 == 0x4 || (opcode[0] == 0x58 && (opcode[1] & 0xF) == 0))
+        {
+            const int16_t displacement = opcode[0] == 0x58 ? static_cast<int16_t>(opcode[2] << 8 | opcode[3]) : static_cast<int8_t>(opcode[1]);
+            loop.isIdle = static_cast<uint16_t>(next + displacement) == head;
+            return loop;
+        }
+
+        // only instructions that can't write memory, anything they do to registers has to repeat exactly to be skipped
+        bool isPolling;
+        switch (opcode[0])
+        {
+        case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27:
+        case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2C: case 0x2D: case 0x2E: case 0x2F:
+            // MOV.B @aa:8, Rd
+            isPolling = addRead(0xFF00 | opcode[1], NO_REGISTER);
+            break;
+        case 0x6A:
+        case 0x6B:
+            // MOV.B / MOV.W @aa:16, Rd
+            isPolling = opcode[1] >> 4 == 0 && addRead(opcode[2] << 8 | opcode[3], NO_REGISTER);
+            break;
+        case 0x68:
+        case 0x69:
+            // MOV.B / MOV.W @ERs, Rd
+            isPolling = !(opcode[1] & 0x80) && addRead(0, opcode[1] >> 4 & 0x7);
+            break;
+        case 0x7E:
+            // BLD @aa:8
+            isPolling = opcode[2] == 0x77 && addRead(0xFF00 | opcode[1], NO_REGISTER);
+            break;
+        case 0x7C:
+            // BLD @ERd
+            isPolling = opcode[2] == 0x77 && addRead(0, opcode[1] >> 4 & 0x7);
+            break;
+        case 0x79:
+            // CMP.W #xx:16, Rd
+            isPolling = opcode[1] >> 4 == 0x2;
+            break;
+        case 0x63: case 0x73: // BTST Rn / #xx:3, Rd
+        case 0x1C: case 0x1D: // CMP.B / CMP.W Rs, Rd
+            isPolling = true;
+            break;
+        default:
+            // CMP.B, OR.B and AND.B #xx:8, Rd
+            isPolling = opcode[0] >> 4 == 0xA || opcode[0] >> 4 == 0xC || opcode[0] >> 4 == 0xE;
+            break;
+        }
+
+        if (!isPolling)
+            return loop;
+
+        address = next;
+    }
+
+    return loop;
+}
+
+bool IdleLoopDetector::IsUnchanged() const
+{
+    cpu->flags->Resolve();
+    return cpu->flags->ccr == ccr && std::memcmp(registers.data(), cpu->registers->buffer, registers.size()) == 0;
+}
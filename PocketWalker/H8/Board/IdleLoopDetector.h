@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+class Cpu;
+class Scheduler;
+
+struct IdleLoop
+{
+    bool isIdle = false;
+    uint32_t generation = 0;
+
+    // one iteration with the closing branch taken
+    uint8_t instructions = 0;
+    size_t cycles = 0;
+
+    // memory operands, register indirect ones are resolved when the loop is skipped
+    uint8_t readCount = 0;
+    std::array<uint16_t, 4> readAddresses = {};
+    std::array<uint8_t, 4> readRegisters = {};
+
+    // diagnostics
+    uint64_t skips = 0;
+    uint64_t skippedCycles = 0;
+};
+
+// spots short backward loops that only poll memory and skips the iterations that can't see a change,
+// memory only changes when a scheduled event fires, so every iteration before the next one goes the same way
+class IdleLoopDetector
+{
+public:
+    IdleLoopDetector(Cpu* cpu, Scheduler* scheduler) : cpu(cpu), scheduler(scheduler)
+    {
+
+    }
+
+    // called before a step, returns the cycles skipped or 0 to run the step
+    uint64_t Skip();
+
+    // called after a step that started at the given pc
+    void Stepped(uint16_t pc);
+
+    // forgets the loop the cpu was going around, the machine state was swapped out from under it
+    void Reset()
+    {
+        loop = nullptr;
+        head = 0;
+        arrivalCycle = UINT64_MAX;
+    }
+
+    const std::map<uint16_t, IdleLoop>& GetLoops() const { return loops; }
+
+    static constexpr uint16_t MAX_LOOP_BYTES = 16;
+    static constexpr uint8_t NO_REGISTER = 0xFF;
+
+private:
+    IdleLoop& Analyze(uint16_t head);
+    bool IsUnchanged() const;
+
+    Cpu* cpu;
+    Scheduler* scheduler;
+
+    std::map<uint16_t, IdleLoop> loops;
+
+    // loop the cpu is currently going around and the state it was last at its head with
+    IdleLoop* loop = nullptr;
+    uint16_t head = 0;
+    uint64_t arrivalCycle = UINT64_MAX;
+    uint8_t ccr = 0;
+    std::array<uint8_t, 32> registers = {};
+};
@@ -0,0 +1,194 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+#include "../../Utilities/StateStream.h"
+
+namespace
+{
+    template<typename T>
+    bool Later(const T& a, const T& b)
+    {
+        return a.deadline != b.deadline ? a.deadline > b.deadline : a.event > b.event;
+    }
+}
+
+size_t Scheduler::Schedule(const size_t period, const ScheduledCallback& callback, const ScheduledIdle& idle)
+{
+    const size_t event = events.size();
+    const uint64_t deadline = period == 0 ? UINT64_MAX : (cycles / period + 1) * period;
+    
+    events.push_back({deadline, period, callback, idle});
+    if (deadline != UINT64_MAX)
+    {
+        Push(deadline, event);
+    }
+
+    return event;
+}
+
+void Scheduler::SetPeriod(const size_t event, const size_t period)
+{
+    if (period == 0)
+        throw std::runtime_error("Cannot schedule an event with a period of 0.");
+    
+    // same deadline a modulo check on the new period would hit next
+    const uint64_t deadline = (cycles / period + 1) * period;
+
+    events[event].period = period;
+    if (events[event].deadline == deadline)
+        return;
+
+    events[event].deadline = deadline;
+    Push(deadline, event);
+}
+
+void Scheduler::SetDeadline(const size_t event, const uint64_t deadline)
+{
+    if (events[event].deadline == deadline)
+        return;
+
+    // UINT64_MAX disarms the event, its queued entry goes stale
+    events[event].deadline = deadline;
+    if (deadline != UINT64_MAX)
+    {
+        Push(deadline, event);
+    }
+}
+
+uint64_t Scheduler::SkipIdle()
+{
+    // nothing can change before the first event that isn't idle, so every idle event until then is a no-op
+    uint64_t target = GetActiveDeadline();
+
+    // with everything idle only input can wake the cpu, so any distance is safe, the slowest periodic event
+    // bounds it so input still gets looked at a few times a second
+    if (target == UINT64_MAX)
+    {
+        uint64_t furthest = 0;
+        for (const Event& event : events)
+        {
+            if (event.deadline != UINT64_MAX)
+            {
+                furthest = std::max(furthest, event.deadline);
+            }
+        }
+
+        if (furthest == 0)
+            throw std::runtime_error("Cannot skip ahead with nothing scheduled.");
+
+        target = furthest;
+    }
+
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        Event& event = events[i];
+        if (event.deadline >= target || !event.IsIdle())
+            continue;
+
+        // a one shot that would have fired as a no-op is spent, same as running it, its queued entry goes stale
+        if (event.period == 0)
+        {
+            event.deadline = UINT64_MAX;
+            continue;
+        }
+
+        // occurrences on the target cycle still fire in order
+        event.deadline = (target + event.period - 1) / event.period * event.period;
+        Push(event.deadline, i);
+    }
+
+    const uint64_t skipped = target - cycles;
+    Advance(skipped);
+
+    return skipped;
+}
+
+uint64_t Scheduler::GetActiveDeadline() const
+{
+    uint64_t deadline = UINT64_MAX;
+    for (const Event& event : events)
+    {
+        if (!event.IsIdle())
+        {
+            deadline = std::min(deadline, event.deadline);
+        }
+    }
+
+    return deadline;
+}
+
+void Scheduler::SaveState(StateWriter& state) const
+{
+    state.Write(cycles);
+    state.Write<uint64_t>(events.size());
+    for (const Event& event : events)
+    {
+        state.Write(event.deadline);
+        state.Write<uint64_t>(event.period);
+    }
+}
+
+void Scheduler::LoadState(StateReader& state)
+{
+    state.Read(cycles);
+
+    const uint64_t count = state.Read<uint64_t>();
+    if (count != events.size())
+        throw std::runtime_error(std::format("Save state has {} scheduled events, this machine has {}.", count, events.size()));
+
+    // the queue is rebuilt without the stale entries the saved one may have had
+    queue.clear();
+    nextDeadline = UINT64_MAX;
+    for (size_t index = 0; index < events.size(); index++)
+    {
+        Event& event = events[index];
+        state.Read(event.deadline);
+        event.period = static_cast<size_t>(state.Read<uint64_t>());
+
+        if (event.deadline != UINT64_MAX)
+        {
+            Push(event.deadline, index);
+        }
+    }
+}
+
+void Scheduler::RunEvents(const uint64_t target)
+{
+    while (!queue.empty() && queue.front().deadline <= target)
+    {
+        std::ranges::pop_heap(queue, Later<Entry>);
+        const Entry entry = queue.back();
+        queue.pop_back();
+
+        Event& event = events[entry.event];
+        if (event.deadline != entry.deadline)
+            continue;
+
+        cycles = entry.deadline;
+        if (event.period != 0)
+        {
+            event.deadline += event.period;
+            Push(event.deadline, entry.event);
+        }
+        else
+        {
+            event.deadline = UINT64_MAX;
+        }
+        
+        event.callback();
+    }
+
+    cycles = target;
+    nextDeadline = queue.empty() ? UINT64_MAX : queue.front().deadline;
+}
+
+void Scheduler::Push(const uint64_t deadline, const size_t event)
+{
+    queue.push_back({deadline, event});
+    std::ranges::push_heap(queue, Later<Entry>);
+
+    nextDeadline = std::min(nextDeadline, deadline);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class StateWriter;
+class StateReader;
+
+using ScheduledCallback = std::function<void()>;
+using ScheduledIdle = std::function<bool()>;
+
+// events keyed on the absolute cycle count, an event with period n fires on every multiple of n,
+// an event with period 0 only fires on the deadline it was last given, events due on the same
+// cycle fire in the order they were scheduled
+class Scheduler
+{
+public:
+    // idle reports whether firing the event right now would change nothing, used to skip ahead
+    size_t Schedule(size_t period, const ScheduledCallback& callback, const ScheduledIdle& idle = nullptr);
+    void SetPeriod(size_t event, size_t period);
+    void SetDeadline(size_t event, uint64_t deadline);
+
+    void Advance(const uint64_t elapsed)
+    {
+        const uint64_t target = cycles + elapsed;
+
+        if (target >= nextDeadline)
+        {
+            RunEvents(target);
+        }
+        else
+        {
+            cycles = target;
+        }
+    }
+
+    uint64_t SkipIdle();
+
+    // the earliest deadline of an event that isn't idle, UINT64_MAX when every event is
+    uint64_t GetActiveDeadline() const;
+
+    // only deadlines and periods, the callbacks belong to whoever scheduled them
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+
+    // current cycle, during an event this is the cycle it fired on
+    uint64_t cycles = 0;
+    uint64_t nextDeadline = UINT64_MAX;
+
+private:
+    struct Event
+    {
+        uint64_t deadline;
+        size_t period;
+        ScheduledCallback callback;
+        ScheduledIdle idle;
+
+        bool IsIdle() const
+        {
+            return idle != nullptr && idle();
+        }
+    };
+    
+    struct Entry
+    {
+        uint64_t deadline;
+        size_t event;
+    };
+
+    void RunEvents(uint64_t target);
+    void Push(uint64_t deadline, size_t event);
+
+    std::vector<Event> events;
+
+    // min-heap on (deadline, event), entries whose deadline no longer matches their event are stale
+    std::vector<Entry> queue;
+};
@@ -0,0 +1,208 @@
+#include "BlockCache.h"
+
+#include <new>
+
+#include "../Cpu.h"
+
+namespace
+{
+    void ExecuteInstruction(Cpu* cpu, const BlockOp& op)
+    {
+        cpu->opcodes->Load(op.address, op.opcode);
+        op.instruction->Run(cpu, op.operands);
+    }
+
+    template<bool BranchIfZero>
+    void ExecuteCompareImmediateBranch(Cpu* cpu, const BlockOp& op)
+    {
+        cpu->flags->Sub(*op.rd, op.imm);
+        cpu->flags->Resolve();
+
+        cpu->registers->pc = op.nextAddress;
+        if (cpu->flags->zero == BranchIfZero)
+            cpu->registers->pc += op.disp;
+    }
+    
+    template<bool BranchIfZero>
+    void ExecuteCompareRegisterBranch(Cpu* cpu, const BlockOp& op)
+    {
+        cpu->flags->Sub(*op.rd, *op.rs);
+        cpu->flags->Resolve();
+
+        cpu->registers->pc = op.nextAddress;
+        if (cpu->flags->zero == BranchIfZero)
+            cpu->registers->pc += op.disp;
+    }
+}
+
+BlockCache::BlockCache(Cpu* cpu) : cpu(cpu), jit(cpu),
+    blocks(static_cast<Block**>(std::calloc(InstructionCache::CODE_END, sizeof(Block*))), &std::free)
+{
+    if (blocks == nullptr)
+        throw std::bad_alloc();
+}
+
+BlockCache::~BlockCache()
+{
+    Clear();
+}
+
+size_t BlockCache::Run()
+{
+    const uint16_t address = cpu->registers->pc;
+    
+    Block* block = blocks[address];
+    if (block == nullptr || block->generation != cpu->instructionCache->generation)
+    {
+        block = Build(address);
+    }
+
+    // nothing decodable here, let the interpreter raise the error
+    if (block->ops.empty())
+    {
+        return cpu->Step();
+    }
+
+    if (block->native != nullptr)
+    {
+        return block->native();
+    }
+
+    if (cpu->jitCompilation && jit.IsAvailable() && ++block->executions == JitCompiler::THRESHOLD)
+    {
+        block->native = jit.Compile(*block);
+        if (block->native == nullptr)
+        {
+            // out of code space, start over with everything cold
+            Clear();
+            return cpu->Step();
+        }
+
+        return block->native();
+    }
+
+    size_t cycles = 0;
+    for (const BlockOp& op : block->ops)
+    {
+        op.handler(cpu, op);
+        
+        cycles += op.cycles;
+        cpu->instructionCount += op.instructionCount;
+
+        // taken branches, sleeps and code writes all leave the block early
+        if (cpu->registers->pc != op.nextAddress || cpu->sleeping || block->generation != cpu->instructionCache->generation)
+            break;
+    }
+
+    return cycles;
+}
+
+void BlockCache::Clear()
+{
+    // walking an empty table would still fault every page of it in
+    for (size_t address = 0; blockCount > 0 && address < InstructionCache::CODE_END; address++)
+    {
+        if (blocks[address] != nullptr)
+        {
+            delete blocks[address];
+            blocks[address] = nullptr;
+            blockCount--;
+        }
+    }
+
+    jit.Reset();
+}
+
+Block* BlockCache::Build(const uint16_t address)
+{
+    auto block = std::make_unique<Block>();
+    block->generation = cpu->instructionCache->generation;
+
+    size_t cycles = 0;
+    uint16_t current = address;
+    while (current < InstructionCache::CODE_END && cycles < MAX_BLOCK_CYCLES)
+    {
+        // hooked addresses have to go through Cpu::Step
+        if (current != address && cpu->HasAddressHandler(current))
+            break;
+        
+        const CachedInstruction* cached = cpu->instructionCache->Fetch(current, cpu->opcodes);
+        if (cached->instruction == nullptr)
+            break;
+
+        BlockOp op = {};
+        op.handler = ExecuteInstruction;
+        op.instruction = cached->instruction;
+        op.address = current;
+        op.nextAddress = current + cached->bytes;
+        op.cycles = cached->cycles;
+        op.instructionCount = 1;
+        std::copy_n(cached->opcode, 8, op.opcode);
+        op.operands = cached->operands;
+
+        if (!Fuse(block->ops, op))
+        {
+            block->ops.push_back(op);
+        }
+        
+        cycles += op.cycles;
+        current = op.nextAddress;
+        
+        if (IsControlFlow(op.instruction))
+            break;
+    }
+
+    if (blocks[address] == nullptr)
+    {
+        blockCount++;
+    }
+
+    delete blocks[address];
+    blocks[address] = block.release();
+    return blocks[address];
+}
+
+bool BlockCache::Fuse(std::vector<BlockOp>& ops, const BlockOp& next) const
+{
+    if (ops.empty())
+        return false;
+
+    BlockOp& previous = ops.back();
+    if (previous.instructionCount != 1)
+        return false;
+
+    // CMP.B followed by BNE/BEQ d:8
+    const uint8_t branch = next.opcode[0];
+    if (branch != 0x46 && branch != 0x47)
+        return false;
+
+    const uint8_t compare = previous.opcode[0];
+    if (compare >> 4 == 0xA)
+    {
+        previous.handler = branch == 0x47 ? ExecuteCompareImmediateBranch<true> : ExecuteCompareImmediateBranch<false>;
+        previous.rd = cpu->registers->Register8(compare & 0xF);
+        previous.imm = previous.opcode[1];
+    }
+    else if (compare == 0x1C)
+    {
+        previous.handler = branch == 0x47 ? ExecuteCompareRegisterBranch<true> : ExecuteCompareRegisterBranch<false>;
+        previous.rs = cpu->registers->Register8(previous.opcode[1] >> 4);
+        previous.rd = cpu->registers->Register8(previous.opcode[1] & 0xF);
+    }
+    else
+    {
+        return false;
+    }
+    
+    previous.disp = static_cast<int8_t>(next.opcode[1]);
+    previous.nextAddress = next.nextAddress;
+    previous.cycles += next.cycles;
+    previous.instructionCount++;
+    
+    return true;
+}
+
+bool BlockCache::IsControlFlow(const Instruction* instruction)
+{
+    return instruction->isControlFlow;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "../Instructions/InstructionCache.h"
+#include "../Jit/JitCompiler.h"
+
+class Cpu;
+struct BlockOp;
+
+using BlockHandler = void(*)(Cpu* cpu, const BlockOp& op);
+
+// one threaded-code entry, either a plain instruction or a fused pair
+struct BlockOp
+{
+    BlockHandler handler;
+    Instruction* instruction;
+    
+    uint16_t address;
+    uint16_t nextAddress;
+    uint8_t opcode[8];
+    uint8_t cycles;
+    uint8_t instructionCount;
+    InstructionOperands operands;
+
+    // operands for fused ops
+    uint8_t* rd;
+    const uint8_t* rs;
+    uint8_t imm;
+    int8_t disp;
+};
+
+struct Block
+{
+    std::vector<BlockOp> ops;
+    uint32_t generation;
+
+    uint32_t executions = 0;
+    NativeBlock native = nullptr;
+};
+
+// straight-line runs of rom code translated once and executed per dispatch
+class BlockCache
+{
+public:
+    BlockCache(Cpu* cpu);
+    ~BlockCache();
+
+    BlockCache(const BlockCache&) = delete;
+    BlockCache& operator=(const BlockCache&) = delete;
+
+    size_t Run();
+    void Clear();
+
+    static bool IsControlFlow(const Instruction* instruction);
+
+    static constexpr size_t MAX_BLOCK_CYCLES = 32;
+
+private:
+    Block* Build(uint16_t address);
+    bool Fuse(std::vector<BlockOp>& ops, const BlockOp& next) const;
+    
+    Cpu* cpu;
+    JitCompiler jit;
+    // owning, zeroed by the allocator like the instruction cache so untouched pages stay unmapped
+    std::unique_ptr<Block*[], decltype(&std::free)> blocks;
+    size_t blockCount = 0;
+};
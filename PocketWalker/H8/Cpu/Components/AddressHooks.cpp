@@ -0,0 +1,91 @@
+#include "AddressHooks.h"
+
+#include <algorithm>
+
+HookId AddressHooks::Add(const uint16_t address, const PCHandler& handler)
+{
+    const auto [slot, isNew] = slots.try_emplace(address, static_cast<uint16_t>(slotHooks.size()));
+    if (isNew)
+    {
+        slotHooks.emplace_back();
+    }
+
+    const HookId id = nextId++;
+    slotHooks[slot->second].push_back({id, address, handler, true});
+    Update(address);
+
+    return id;
+}
+
+bool AddressHooks::Remove(const HookId id)
+{
+    const AddressHook* hook = FindHook(id);
+    if (hook == nullptr)
+        return false;
+
+    const uint16_t address = hook->address;
+    std::erase_if(slotHooks[slots.at(address)], [id](const AddressHook& other)
+    {
+        return other.id == id;
+    });
+
+    Update(address);
+    return true;
+}
+
+bool AddressHooks::SetEnabled(const HookId id, const bool enabled)
+{
+    AddressHook* hook = FindHook(id);
+    if (hook == nullptr)
+        return false;
+
+    hook->isEnabled = enabled;
+    Update(hook->address);
+    return true;
+}
+
+const AddressHook* AddressHooks::Find(const HookId id) const
+{
+    for (const auto& hooks : slotHooks)
+    {
+        const auto hook = std::ranges::find(hooks, id, &AddressHook::id);
+        if (hook != hooks.end())
+            return &*hook;
+    }
+
+    return nullptr;
+}
+
+PCHandlerResult AddressHooks::Run(Cpu* cpu, const uint16_t address)
+{
+    const uint16_t slot = slots.at(address);
+
+    // handlers can add and remove hooks themselves, so the list is indexed again for each one
+    for (size_t index = 0; index < slotHooks[slot].size(); index++)
+    {
+        if (!slotHooks[slot][index].isEnabled)
+            continue;
+
+        const PCHandler handler = slotHooks[slot][index].handler;
+        if (handler(cpu) == SkipInstruction)
+            return SkipInstruction;
+    }
+
+    return Continue;
+}
+
+AddressHook* AddressHooks::FindHook(const HookId id)
+{
+    return const_cast<AddressHook*>(Find(id));
+}
+
+void AddressHooks::Update(const uint16_t address)
+{
+    const bool isHooked = std::ranges::any_of(slotHooks[slots.at(address)], &AddressHook::isEnabled);
+    const uint64_t bit = 1ull << (address & 0x3F);
+
+    if (isHooked)
+        present[address >> 6] |= bit;
+    else
+        present[address >> 6] &= ~bit;
+}
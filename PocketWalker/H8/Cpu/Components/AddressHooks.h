@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class Cpu;
+
+enum PCHandlerResult : uint8_t
+{
+    Continue,
+    SkipInstruction
+};
+
+using PCHandler = std::function<PCHandlerResult(Cpu*)>;
+
+// handle for a single hook, stays valid until the hook is removed
+using HookId = uint32_t;
+
+struct AddressHook
+{
+    HookId id;
+    uint16_t address;
+    PCHandler handler;
+    bool isEnabled;
+};
+
+// handlers keyed on pc, a bit per address says if any enabled hook is there so the common case is a single test
+class AddressHooks
+{
+public:
+    HookId Add(uint16_t address, const PCHandler& handler);
+    bool Remove(HookId id);
+    bool SetEnabled(HookId id, bool enabled);
+    const AddressHook* Find(HookId id) const;
+
+    bool Contains(const uint16_t address) const
+    {
+        return present[address >> 6] >> (address & 0x3F) & 1;
+    }
+
+    // runs the enabled hooks at the address in the order they were added, the first to skip the instruction ends it
+    PCHandlerResult Run(Cpu* cpu, uint16_t address);
+
+private:
+    AddressHook* FindHook(HookId id);
+    void Update(uint16_t address);
+
+    std::array<uint64_t, 0x10000 / 64> present = {};
+
+    // addresses that ever had a hook get a slot in the dense list, it's kept when the last hook goes,
+    // only looked up once the bit says there's a hook so it doesn't need to be a flat table
+    std::unordered_map<uint16_t, uint16_t> slots;
+    std::vector<std::vector<AddressHook>> slotHooks;
+
+    HookId nextId = 1;
+};
@@ -1,8 +1,19 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 class Board;
 
+enum class FlagOperation : uint8_t
+{
+    None,
+    Mov,
+    Add,
+    Sub,
+    Inc,
+    Dec
+};
+
 class Flags
 {
 public:
@@ -21,9 +32,128 @@ public:
     };
 
     template<typename T>
-    void Mov(T value, size_t bits = sizeof(T) * 8)
+    void Mov(T value)
+    {
+        if (lazy)
+            Defer(FlagOperation::Mov, sizeof(T), value, 0);
+        else
+            ApplyMov(value);
+    }
+
+    template<typename T>
+    void Add(T rdValue, T rsValue)
+    {
+        if (lazy)
+            Defer(FlagOperation::Add, sizeof(T), rdValue, rsValue);
+        else
+            ApplyAdd(rdValue, rsValue);
+    }
+    
+    template<typename T>
+    void Sub(T rdValue, T rsValue)
+    {
+        if (lazy)
+            Defer(FlagOperation::Sub, sizeof(T), rdValue, rsValue);
+        else
+            ApplySub(rdValue, rsValue);
+    }
+
+    template<typename T>
+    void Inc(T value, size_t inc)
+    {
+        if (lazy)
+            Defer(FlagOperation::Inc, sizeof(T), value, inc);
+        else
+            ApplyInc(value, inc);
+    }
+
+    template<typename T>
+    void Dec(T value, size_t dec)
+    {
+        if (lazy)
+            Defer(FlagOperation::Dec, sizeof(T), value, dec);
+        else
+            ApplyDec(value, dec);
+    }
+
+    // writes a deferred update into ccr, anything reading or partially writing the bits has to call this first
+    void Resolve()
+    {
+        if (pending == FlagOperation::None)
+            return;
+
+        switch (pendingSize)
+        {
+        case 1:
+            Apply<uint8_t>();
+            break;
+        case 2:
+            Apply<uint16_t>();
+            break;
+        default:
+            Apply<uint32_t>();
+            break;
+        }
+
+        pending = FlagOperation::None;
+    }
+
+    static constexpr uint32_t NegativeMask(size_t bits)
+    {
+        return 1 << (bits - 1);   
+    }
+
+    // only records the last operation and its operands, see Resolve
+    bool lazy = false;
+
+private:
+    void Defer(const FlagOperation operation, const uint8_t size, const uint32_t first, const uint32_t second)
+    {
+        // Mov, Inc and Dec leave carry and half carry alone, so an earlier Add or Sub still has to land
+        const bool setsCarry = operation == FlagOperation::Add || operation == FlagOperation::Sub;
+        const bool pendingCarry = pending == FlagOperation::Add || pending == FlagOperation::Sub;
+        if (pendingCarry && !setsCarry)
+        {
+            Resolve();
+        }
+
+        pending = operation;
+        pendingSize = size;
+        pendingFirst = first;
+        pendingSecond = second;
+    }
+
+    template<typename T>
+    void Apply()
+    {
+        const T first = static_cast<T>(pendingFirst);
+        switch (pending)
+        {
+        case FlagOperation::Mov:
+            ApplyMov(first);
+            break;
+        case FlagOperation::Add:
+            ApplyAdd(first, static_cast<T>(pendingSecond));
+            break;
+        case FlagOperation::Sub:
+            ApplySub(first, static_cast<T>(pendingSecond));
+            break;
+        case FlagOperation::Inc:
+            ApplyInc(first, pendingSecond);
+            break;
+        case FlagOperation::Dec:
+            ApplyDec(first, pendingSecond);
+            break;
+        default:
+            break;
+        }
+    }
+
+    template<typename T>
+    void ApplyMov(T value)
     {
-        const uint32_t negativeMask = NegativeMask(bits);
+        constexpr size_t bits = sizeof(T) * 8;
+        constexpr uint32_t negativeMask = NegativeMask(bits);
 
         negative = value & negativeMask;
         zero = value == 0;
@@ -31,23 +161,28 @@ public:
     }
 
     template<typename T>
-    void Add(T rdValue, T rsValue, size_t bits = sizeof(T) * 8)
+    void ApplyAdd(T rdValue, T rsValue)
     {
-        const uint32_t negativeMask = NegativeMask(bits);
-        const uint32_t maxValue = (1 << bits) - 1;
-        const uint32_t result = rdValue + rsValue;
+        constexpr size_t bits = sizeof(T) * 8;
+        constexpr uint32_t negativeMask = NegativeMask(bits);
+        constexpr uint64_t maxValue = (1ull << bits) - 1;
+        
+        // widened so the carry out of a long add isn't lost
+        const uint64_t sum = static_cast<uint64_t>(rdValue) + rsValue;
+        const uint32_t result = static_cast<uint32_t>(sum);
 
         zero = result == 0;
         negative = result & negativeMask;
         overflow = ((rdValue ^ rsValue) & (rdValue ^ result) & negativeMask) != 0;
-        carry = result > maxValue;
+        carry = sum > maxValue;
         halfCarry = ((rdValue ^ rsValue ^ result) >> (bits / 2 - 1) & 1) != 0;
     }
     
     template<typename T>
-    void Sub(T rdValue, T rsValue, size_t bits = sizeof(T) * 8)
+    void ApplySub(T rdValue, T rsValue)
     {
-        const uint32_t negativeMask = NegativeMask(bits);
+        constexpr size_t bits = sizeof(T) * 8;
+        constexpr uint32_t negativeMask = NegativeMask(bits);
         const uint32_t result = rdValue - rsValue;
 
         zero = result == 0;
@@ -58,9 +193,10 @@ public:
     }
 
     template<typename T>
-    void Inc(T value, size_t inc, size_t bits = sizeof(T) * 8)
+    void ApplyInc(T value, size_t inc)
     {
-        const uint32_t negativeMask = NegativeMask(bits);
+        constexpr size_t bits = sizeof(T) * 8;
+        constexpr uint32_t negativeMask = NegativeMask(bits);
         const uint32_t result = value + inc;
         
         negative = result & negativeMask;
@@ -69,19 +205,19 @@ public:
     }
 
     template<typename T>
-    void Dec(T value, size_t dec, size_t bits = sizeof(T) * 8)
+    void ApplyDec(T value, size_t dec)
     {
-        const uint32_t negativeMask = NegativeMask(bits);
+        constexpr size_t bits = sizeof(T) * 8;
+        constexpr uint32_t negativeMask = NegativeMask(bits);
         const uint32_t result = value - dec;
         
         negative = result & negativeMask;
         zero = result == 0;
         overflow = value == negativeMask;
     }
-    
-    static uint32_t NegativeMask(size_t bits)
-    {
-        return 1 << (bits - 1);   
-    }
-    
+
+    FlagOperation pending = FlagOperation::None;
+    uint8_t pendingSize = 0;
+    uint32_t pendingFirst = 0;
+    uint32_t pendingSecond = 0;
 };
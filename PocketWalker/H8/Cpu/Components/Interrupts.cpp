@@ -1,50 +1,84 @@
+#include <array>
+#include <bit>
 #include <print>
 #include "Interrupts.h"
 
 #include "../Cpu.h"
 
+namespace
+{
+    // in priority order, matching the bits of the pending mask from the top down
+    constexpr std::array<uint16_t VectorTable::*, 9> VECTORS = {
+        &VectorTable::irq0,
+        &VectorTable::irq1,
+        &VectorTable::quarterSecond,
+        &VectorTable::halfSecond,
+        &VectorTable::second,
+        &VectorTable::minute,
+        &VectorTable::hour,
+        &VectorTable::timerB1,
+        &VectorTable::timerW
+    };
+}
+
+InterruptRegister& InterruptRegister::operator=(const uint8_t value)
+{
+    MemoryAccessor::operator=(value);
+    interrupts->Refresh();
+    return *this;
+}
+
+InterruptRegister& InterruptRegister::operator&=(const uint8_t value)
+{
+    MemoryAccessor::operator&=(value);
+    interrupts->Refresh();
+    return *this;
+}
+
+InterruptRegister& InterruptRegister::operator|=(const uint8_t value)
+{
+    MemoryAccessor::operator|=(value);
+    interrupts->Refresh();
+    return *this;
+}
+
+void InterruptRegister::Set(const uint8_t value)
+{
+    MemoryAccessor::Set(value);
+    interrupts->Refresh();
+}
+
 void Interrupts::Update(Cpu* cpu)
 {
-    if (enable1 & InterruptFlags::ENABLE_IRQ0 && flag1 & InterruptFlags::FLAG_IRQ0)
-    {
-        Interrupt(cpu, cpu->vectorTable->irq0);
-    }
-    else if (enable1 & InterruptFlags::ENABLE_IRQ1 && flag1 & InterruptFlags::FLAG_IRQ1)
-    {
-        Interrupt(cpu, cpu->vectorTable->irq1);
-    }
-    else if (enable1 & InterruptFlags::ENABLE_RTC && rtcFlag & InterruptFlags::FLAG_QUARTER_SECOND)
-    {
-        Interrupt(cpu, cpu->vectorTable->quarterSecond);
-    }
-    else if (enable1 & InterruptFlags::ENABLE_RTC && rtcFlag & InterruptFlags::FLAG_HALF_SECOND)
-    {
-        Interrupt(cpu, cpu->vectorTable->halfSecond);
-    }
-    else if (enable1 & InterruptFlags::ENABLE_RTC && rtcFlag & InterruptFlags::FLAG_SECOND)
-    {
-        Interrupt(cpu, cpu->vectorTable->second);
-    }
-    else if (enable1 & InterruptFlags::ENABLE_RTC && rtcFlag & InterruptFlags::FLAG_MINUTE)
-    {
-        Interrupt(cpu, cpu->vectorTable->minute);
-    }
-    else if (enable1 & InterruptFlags::ENABLE_RTC && rtcFlag & InterruptFlags::FLAG_HOUR)
+    if (pending != 0)
     {
-        Interrupt(cpu, cpu->vectorTable->hour);
-    }
-    else if (enable2 & InterruptFlags::ENABLE_TIMER_B1 && flag2 & InterruptFlags::FLAG_TIMER_B1)
-    {
-        Interrupt(cpu, cpu->vectorTable->timerB1);
-    }
-    else if (enableTimerW & InterruptFlags::ENABLE_TIMER_W_REGISTER_A && flagTimerW & InterruptFlags::FLAG_TIMER_W_REGISTER_A)
-    {
-        Interrupt(cpu, cpu->vectorTable->timerW);
+        Interrupt(cpu, cpu->vectorTable->*VECTORS[std::countl_zero(pending)]);
     }
 }
 
+void Interrupts::Refresh()
+{
+    const uint8_t irq = enable1 & flag1;
+    const uint8_t rtc = enable1 & InterruptFlags::ENABLE_RTC ? rtcFlag.Get() : 0;
+
+    uint16_t mask = 0;
+    mask |= irq & InterruptFlags::FLAG_IRQ0 ? 1 << 15 : 0;
+    mask |= irq & InterruptFlags::FLAG_IRQ1 ? 1 << 14 : 0;
+    mask |= rtc & InterruptFlags::FLAG_QUARTER_SECOND ? 1 << 13 : 0;
+    mask |= rtc & InterruptFlags::FLAG_HALF_SECOND ? 1 << 12 : 0;
+    mask |= rtc & InterruptFlags::FLAG_SECOND ? 1 << 11 : 0;
+    mask |= rtc & InterruptFlags::FLAG_MINUTE ? 1 << 10 : 0;
+    mask |= rtc & InterruptFlags::FLAG_HOUR ? 1 << 9 : 0;
+    mask |= enable2 & flag2 & InterruptFlags::FLAG_TIMER_B1 ? 1 << 8 : 0;
+    mask |= enableTimerW & flagTimerW & InterruptFlags::FLAG_TIMER_W_REGISTER_A ? 1 << 7 : 0;
+
+    pending = mask;
+}
+
 void Interrupts::Interrupt(Cpu* cpu, uint16_t address)
 {
+    cpu->flags->Resolve();
+    
     savedAddress = cpu->registers->pc;
     savedFlags = cpu->flags->ccr;
 
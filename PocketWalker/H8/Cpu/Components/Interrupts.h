@@ -71,35 +71,69 @@ namespace InterruptFlags
 }
 
 
+class Interrupts;
+
+// enable/flag register that refreshes the pending mask whenever hardware writes it
+class InterruptRegister : public MemoryAccessor<uint8_t>
+{
+public:
+    InterruptRegister(const MemoryAccessor& accessor, Interrupts* interrupts) : MemoryAccessor(accessor), interrupts(interrupts) {}
+
+    InterruptRegister& operator=(uint8_t value);
+    InterruptRegister& operator&=(uint8_t value);
+    InterruptRegister& operator|=(uint8_t value);
+    void Set(uint8_t value);
+
+private:
+    Interrupts* interrupts;
+};
+
 class Interrupts
 {
 public:
-    Interrupts(Memory* ram) : ram(ram),
-        enable1(ram->CreateAccessor<uint8_t>(IENR1_ADDR)),
-        enable2(ram->CreateAccessor<uint8_t>(IENR2_ADDR)),
-        flag1(ram->CreateAccessor<uint8_t>(IRR1_ADDR)),
-        flag2(ram->CreateAccessor<uint8_t>(IRR2_ADDR)),
-        rtcFlag(ram->CreateAccessor<uint8_t>(RTC_ADDR)),
-        enableTimerW(ram->CreateAccessor<uint8_t>(TIMER_W_ENABLE_ADDR)),
-        flagTimerW(ram->CreateAccessor<uint8_t>(TIMER_W_FLAG_ADDR))
+    Interrupts(Memory* ram) :
+        enable1(ram->CreateAccessor<uint8_t>(IENR1_ADDR), this),
+        enable2(ram->CreateAccessor<uint8_t>(IENR2_ADDR), this),
+        flag1(ram->CreateAccessor<uint8_t>(IRR1_ADDR), this),
+        flag2(ram->CreateAccessor<uint8_t>(IRR2_ADDR), this),
+        rtcFlag(ram->CreateAccessor<uint8_t>(RTC_ADDR), this),
+        enableTimerW(ram->CreateAccessor<uint8_t>(TIMER_W_ENABLE_ADDR), this),
+        flagTimerW(ram->CreateAccessor<uint8_t>(TIMER_W_FLAG_ADDR), this),
+        ram(ram)
     {
-        
+        for (const uint16_t address : {IENR1_ADDR, IENR2_ADDR, IRR1_ADDR, IRR2_ADDR, RTC_ADDR, TIMER_W_ENABLE_ADDR, TIMER_W_FLAG_ADDR})
+        {
+            // a word or long write can cover these without starting on them
+            ram->OnWriteCovering(address, [this](uint32_t, bool)
+            {
+                Refresh();
+            });
+        }
     }
 
     void Update(Cpu* cpu);
+    void Refresh();
     void Interrupt(Cpu* cpu, uint16_t address);
 
+    bool IsPending() const
+    {
+        return pending != 0;
+    }
+
     uint8_t savedFlags;
     uint16_t savedAddress;
+
+    // one bit per enabled and flagged source, highest priority in the top bit
+    uint16_t pending = 0;
     
-    MemoryAccessor<uint8_t> enable1;
-    MemoryAccessor<uint8_t> enable2;
-    MemoryAccessor<uint8_t> flag1;
-    MemoryAccessor<uint8_t> flag2;
+    InterruptRegister enable1;
+    InterruptRegister enable2;
+    InterruptRegister flag1;
+    InterruptRegister flag2;
     
-    MemoryAccessor<uint8_t> rtcFlag;
-    MemoryAccessor<uint8_t> enableTimerW;
-    MemoryAccessor<uint8_t> flagTimerW;
+    InterruptRegister rtcFlag;
+    InterruptRegister enableTimerW;
+    InterruptRegister flagTimerW;
 
 private:
     Memory* ram;
@@ -20,6 +20,22 @@ void Opcode::Update(const uint16_t address)
     }
 }
 
+void Opcode::Load(const uint16_t address, const uint8_t* bytes)
+{
+    currentAddress = address;
+
+    for (int index = 0; index < 8; index++)
+    {
+        cacheBytes[index] = bytes[index];
+        validFlags[index] = true;
+    }
+}
+
+bool Opcode::IsFetched(const int index) const
+{
+    return validFlags[index];
+}
+
 uint8_t Opcode::get_byte(int index) const
 {
     if (!validFlags[index]) {
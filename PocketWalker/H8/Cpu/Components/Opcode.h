@@ -9,6 +9,8 @@ public:
     Opcode(Memory* ram);
 
     void Update(uint16_t address);
+    void Load(uint16_t address, const uint8_t* bytes);
+    bool IsFetched(int index) const;
     
     uint8_t a() const;
     uint8_t b() const;
@@ -16,20 +16,58 @@ public:
     Registers(Memory* ram) : ram(ram)
     {
 #if ANDROID
-        buffer = static_cast<uint8_t*>(std::aligned_alloc(4, 32));
-        std::fill_n(buffer, 32, 0);
+        buffer = static_cast<uint8_t*>(std::aligned_alloc(4, SIZE));
+        std::fill_n(buffer, SIZE, 0);
 #else
-        buffer = new uint8_t[32]();
+        buffer = new uint8_t[SIZE]();
 #endif
 
         sp = Register32(7);
     }
 
-    uint8_t* Register8(const uint8_t control) const;
+    ~Registers()
+    {
+#if ANDROID
+        std::free(buffer);
+#else
+        delete[] buffer;
+#endif
+    }
 
-    uint16_t* Register16(const uint8_t control) const;
+    Registers(const Registers&) = delete;
+    Registers& operator=(const Registers&) = delete;
 
-    uint32_t* Register32(const uint8_t control) const;
+    uint8_t* Register8(const uint8_t control) const
+    {
+        const uint8_t regIndex = control & 0b111;
+        const uint8_t offset = ~(control >> 3) & 1;
+        return &this->buffer[regIndex * 4 + offset];
+    }
+
+    uint16_t* Register16(const uint8_t control) const
+    {
+        const uint8_t regIndex = control & 0b111;
+        const uint8_t offset = control >> 3 & 1;
+        return &reinterpret_cast<uint16_t*>(this->buffer)[regIndex * 2 + offset];
+    }
+
+    uint32_t* Register32(const uint8_t control) const
+    {
+        const uint8_t regIndex = control & 0b111;
+        return &reinterpret_cast<uint32_t*>(this->buffer)[regIndex];
+    }
+
+    // picks the register file view from the operand size
+    template<typename T>
+    T* Register(const uint8_t control) const
+    {
+        if constexpr (sizeof(T) == 1)
+            return Register8(control);
+        else if constexpr (sizeof(T) == 2)
+            return Register16(control);
+        else
+            return Register32(control);
+    }
 
     void PushStack() const;
     uint16_t PopStack() const;
@@ -42,6 +80,9 @@ public:
 #endif
     uint8_t* buffer;
 
+    // eight 32 bit general registers
+    static constexpr size_t SIZE = 32;
+
 private:
     Memory* ram;
 };
@@ -1,5 +1,8 @@
 #include "Cpu.h"
 #include <print>
+#include <utility>
+
+#include "../../Utilities/StateStream.h"
 
 size_t Cpu::Step()
 {
@@ -10,22 +13,48 @@ size_t Cpu::Step()
         throw std::runtime_error("Program finished execution.");
     }
 
-    opcodes->Update(registers->pc);
+    const CachedInstruction* cached = instructionCache->Fetch(registers->pc, opcodes);
     
     PCHandlerResult handlerResult = Continue;
-    if (addressHandlers.contains(registers->pc))
+    size_t replacedCycles = 0;
+    if (hooks->Contains(registers->pc))
     {
-        handlerResult = addressHandlers[registers->pc](this);
+        handlerResult = hooks->Run(this, registers->pc);
+        replacedCycles = std::exchange(handlerCycles, 0);
     }
     
     if (!sleeping && handlerResult != SkipInstruction)
     {
-        const Instruction* instruction = instructions->Execute(this);
-        cycleCount = instruction->cycles;
+        if (cached->instruction != nullptr)
+        {
+            cached->instruction->Run(this, cached->operands);
+            cycleCount = cached->cycles;
+        }
+        else
+        {
+            cycleCount = instructions->Execute(this)->cycles;
+        }
+        
         instructionCount++;
     }
 
-    return cycleCount;
+    return cycleCount + replacedCycles;
+}
+
+size_t Cpu::StepBlock()
+{
+    const uint16_t pc = registers->pc;
+    if (sleeping || pc == 0x0000 || pc >= InstructionCache::CODE_END || hooks->Contains(pc))
+    {
+        return Step();
+    }
+
+    if (const RecompiledBlock block = recompiled->Find(pc))
+    {
+        return block(this);
+    }
+
+    return blocks->Run();
 }
 
 void Cpu::UpdateInterrupts()
@@ -33,7 +62,84 @@ void Cpu::UpdateInterrupts()
     interrupts->Update(this);
 }
 
-void Cpu::OnAddress(const uint16_t address, const PCHandler& handler)
+HookId Cpu::OnAddress(const uint16_t address, const PCHandler& handler)
+{
+    const bool wasHooked = hooks->Contains(address);
+    const HookId id = hooks->Add(address, handler);
+
+    if (!wasHooked)
+        RefreshAddressHandlers();
+
+    return id;
+}
+
+bool Cpu::RemoveAddressHandler(const HookId id)
+{
+    const AddressHook* hook = hooks->Find(id);
+    if (hook == nullptr)
+        return false;
+
+    const uint16_t address = hook->address;
+    const bool wasHooked = hooks->Contains(address);
+    hooks->Remove(id);
+
+    if (wasHooked != hooks->Contains(address))
+        RefreshAddressHandlers();
+
+    return true;
+}
+
+bool Cpu::SetAddressHandlerEnabled(const HookId id, const bool enabled)
+{
+    const AddressHook* hook = hooks->Find(id);
+    if (hook == nullptr)
+        return false;
+
+    const uint16_t address = hook->address;
+    const bool wasHooked = hooks->Contains(address);
+    hooks->SetEnabled(id, enabled);
+
+    if (wasHooked != hooks->Contains(address))
+        RefreshAddressHandlers();
+
+    return true;
+}
+
+void Cpu::SaveState(StateWriter& state) const
+{
+    // a deferred flag update is written out the way it would have resolved
+    Flags resolved = *flags;
+    resolved.Resolve();
+
+    state.WriteBytes(registers->buffer, Registers::SIZE);
+    state.Write(registers->pc);
+    state.Write(resolved.ccr);
+    state.Write(interrupts->savedFlags);
+    state.Write(interrupts->savedAddress);
+    state.Write(sleeping);
+    state.Write<uint64_t>(instructionCount);
+    state.Write<uint64_t>(handlerCycles);
+}
+
+void Cpu::LoadState(StateReader& state)
+{
+    flags->Resolve();
+
+    state.ReadBytes(registers->buffer, Registers::SIZE);
+    state.Read(registers->pc);
+    state.Read(flags->ccr);
+    state.Read(interrupts->savedFlags);
+    state.Read(interrupts->savedAddress);
+    state.Read(sleeping);
+    instructionCount = static_cast<size_t>(state.Read<uint64_t>());
+    handlerCycles = static_cast<size_t>(state.Read<uint64_t>());
+
+    interrupts->Refresh();
+}
+
+void Cpu::RefreshAddressHandlers()
 {
-    addressHandlers[address] = handler;
+    // blocks and recompiled code end before hooked addresses, so they go whenever the set of them changes
+    blocks->Clear();
+    recompiled->Refresh();
 }
@@ -1,62 +1,102 @@
 #pragma once
 #include <cstdint>
 
+#include "Components/AddressHooks.h"
 #include "Components/Opcode.h"
 #include "Components/Registers.h"
 #include "Components/Flags.h"
 #include "Components/VectorTable.h"
 #include "Components/Interrupts.h"
 #include "Instructions/InstructionTable.h"
+#include "Instructions/InstructionCache.h"
+#include "Blocks/BlockCache.h"
+#include "Recompiled/RecompiledBackend.h"
 
 class Interrupts;
 class Memory;
 class Board;
+class StateWriter;
+class StateReader;
 
 class Opcode;
 class Registers;
 class Flags;
 
-enum PCHandlerResult : uint8_t
-{
-    Continue,
-    SkipInstruction
-};
-
-using PCHandler = std::function<PCHandlerResult(Cpu*)>;
-
 class Cpu
 {
 public:
     Cpu(Memory* ram) : ram(ram)
     {
-        instructions = new InstructionTable();
+        instructions = InstructionTable::Shared();
         opcodes = new Opcode(ram);
         registers = new Registers(ram);
+        instructionCache = new InstructionCache(ram, instructions, registers);
         vectorTable = new VectorTable(ram);
         interrupts = new Interrupts(ram);
         flags = new Flags();
+        blocks = new BlockCache(this);
+        recompiled = new RecompiledBackend(this);
+        hooks = new AddressHooks();
 
         registers->pc = vectorTable->reset;
     }
 
+    // the instruction table is shared by every cpu and stays
+    ~Cpu()
+    {
+        delete hooks;
+        delete recompiled;
+        delete blocks;
+        delete flags;
+        delete interrupts;
+        delete vectorTable;
+        delete instructionCache;
+        delete registers;
+        delete opcodes;
+    }
+
+    Cpu(const Cpu&) = delete;
+    Cpu& operator=(const Cpu&) = delete;
+
     size_t Step();
+    size_t StepBlock();
     void UpdateInterrupts();
-    void OnAddress(uint16_t address, const PCHandler& handler);
+    HookId OnAddress(uint16_t address, const PCHandler& handler);
+    bool RemoveAddressHandler(HookId id);
+    bool SetAddressHandlerEnabled(HookId id, bool enabled);
+    bool HasAddressHandler(const uint16_t address) const { return hooks->Contains(address); }
+
+    // registers, flags and interrupt entry state, the pending mask is worked out again from ram on load
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
 
     Memory* ram;
     
     Opcode* opcodes;
     InstructionTable* instructions;
+    InstructionCache* instructionCache;
     VectorTable* vectorTable;
     Interrupts* interrupts;
     Registers* registers;
     Flags* flags;
+    BlockCache* blocks;
+    RecompiledBackend* recompiled;
+    AddressHooks* hooks;
 
-    size_t instructionCount;
+    size_t instructionCount = 0;
+
+    // operands of the instruction being run, instructions decoded on the spot resolve theirs into decodedOperands
+    const InstructionOperands* operands = nullptr;
+    InstructionOperands decodedOperands;
+    
+    // cycles an address handler spent standing in for rom code, charged to the step it ran on
+    size_t handlerCycles = 0;
     bool sleeping = false;
+    bool blockExecution = false;
+    bool jitCompilation = true;
 
     static constexpr uint32_t TICKS = 3686400;
 
 private:
-    std::map<uint16_t, PCHandler> addressHandlers;
+    void RefreshAddressHandlers();
 };
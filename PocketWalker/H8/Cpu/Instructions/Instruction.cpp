@@ -1 +1,20 @@
 #include "Instruction.h"
+
+#include "../Cpu.h"
+
+void Instruction::Run(Cpu* cpu, const InstructionOperands& operands) const
+{
+    cpu->operands = &operands;
+    
+    if (execute != nullptr)
+    {
+        execute(cpu);
+    }
+    
+    cpu->registers->pc += bytes;
+
+    if (postExecute != nullptr)
+    {
+        postExecute(cpu);
+    }
+}
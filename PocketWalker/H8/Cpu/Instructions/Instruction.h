@@ -1,22 +1,56 @@
 #pragma once
-#include <functional>
+#include <cstdint>
 #include <string>
 
 class InstructionContainer;
 class Cpu;
+class Opcode;
+class Registers;
 
-using InstructionExecute = std::function<void(Cpu*)>;
+// captureless lambdas and templated handlers both decay to this
+using InstructionExecute = void(*)(Cpu* cpu);
+
+// what an instruction works on, pulled out of the opcode once when it's cached instead of on every run
+struct InstructionOperands
+{
+    void* source = nullptr;
+    void* destination = nullptr;
+    uint32_t immediate = 0;
+    int32_t displacement = 0;
+};
+
+using InstructionDecode = void(*)(const Opcode* opcode, const Registers* registers, InstructionOperands& operands);
 
 struct Instruction
 {
     std::string name;
-    size_t bytes;
-    size_t cycles;
-    InstructionExecute execute;
-    InstructionExecute postExecute;
-    InstructionContainer* parentContainer;
+    size_t bytes = 0;
+    size_t cycles = 0;
+    InstructionExecute execute = nullptr;
+    InstructionExecute postExecute = nullptr;
+    InstructionContainer* parentContainer = nullptr;
+
+    // handlers without one still read the opcode themselves
+    InstructionDecode decode = nullptr;
+
+    // set when the table is built for anything that moves the pc somewhere else or stops the cpu
+    bool isControlFlow = false;
 
     Instruction() = default;
-    Instruction(const std::string& name, const int bytes, const int cycles, const InstructionExecute& execute, const InstructionExecute& postExecute = nullptr, InstructionContainer* parentContainer = nullptr)
+    Instruction(const std::string& name, const int bytes, const int cycles, const InstructionExecute execute, const InstructionExecute postExecute = nullptr, InstructionContainer* parentContainer = nullptr)
         : name(name), bytes(bytes), cycles(cycles), execute(execute), postExecute(postExecute), parentContainer(parentContainer) { }
+    Instruction(const std::string& name, const int bytes, const int cycles, const InstructionExecute execute, const InstructionDecode decode)
+        : name(name), bytes(bytes), cycles(cycles), execute(execute), decode(decode) { }
+    Instruction(const std::string& name, const int bytes, const int cycles, const InstructionExecute execute, const InstructionExecute postExecute, const InstructionDecode decode)
+        : name(name), bytes(bytes), cycles(cycles), execute(execute), postExecute(postExecute), decode(decode) { }
+
+    void Resolve(const Opcode* opcode, const Registers* registers, InstructionOperands& operands) const
+    {
+        if (decode != nullptr)
+        {
+            decode(opcode, registers, operands);
+        }
+    }
+
+    void Run(Cpu* cpu, const InstructionOperands& operands) const;
 };
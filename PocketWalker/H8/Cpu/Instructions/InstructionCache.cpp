@@ -0,0 +1,88 @@
+#include "InstructionCache.h"
+
+#include <algorithm>
+
+#include "InstructionTable.h"
+#include "../Components/Opcode.h"
+#include "../../Memory/Memory.h"
+
+InstructionCache::InstructionCache(Memory* ram, InstructionTable* instructions, Registers* registers) : ram(ram), instructions(instructions), registers(registers)
+{
+    ram->OnWriteRange(0, CODE_END, [this](const uint16_t address, const size_t size)
+    {
+        Invalidate(address, size);
+    });
+}
+
+const CachedInstruction* InstructionCache::Fetch(const uint16_t address, Opcode* opcode)
+{
+    if (address >= CODE_END)
+    {
+        Fill(uncached, address, opcode);
+        return &uncached;
+    }
+    
+    std::unique_ptr<CachedInstruction[]>& page = pages[address >> PAGE_SHIFT];
+    if (page == nullptr)
+    {
+        page = std::make_unique<CachedInstruction[]>(PAGE_SIZE);
+    }
+
+    CachedInstruction& entry = page[address & (PAGE_SIZE - 1)];
+    if (entry.instruction == nullptr)
+    {
+        Fill(entry, address, opcode);
+        return &entry;
+    }
+    
+    opcode->Load(address, entry.opcode);
+    return &entry;
+}
+
+void InstructionCache::Invalidate(const uint16_t address, const size_t size)
+{
+    // an instruction is at most 8 bytes, so anything starting 7 bytes back may overlap the write
+    const size_t start = address >= 7 ? address - 7 : 0;
+    const size_t end = std::min<size_t>(address + size, CODE_END);
+    for (size_t pc = start; pc < end; pc++)
+    {
+        if (pages[pc >> PAGE_SHIFT] != nullptr)
+        {
+            pages[pc >> PAGE_SHIFT][pc & (PAGE_SIZE - 1)].instruction = nullptr;
+        }
+    }
+
+    generation++;
+}
+
+void InstructionCache::Clear()
+{
+    // entries can still be pointed at, so pages are emptied rather than freed
+    for (const std::unique_ptr<CachedInstruction[]>& page : pages)
+    {
+        if (page != nullptr)
+        {
+            std::fill_n(page.get(), PAGE_SIZE, CachedInstruction());
+        }
+    }
+
+    generation++;
+}
+
+void InstructionCache::Fill(CachedInstruction& entry, const uint16_t address, Opcode* opcode) const
+{
+    for (uint16_t index = 0; index < 8; index++)
+    {
+        entry.opcode[index] = ram->ReadByte(static_cast<uint16_t>(address + index));
+    }
+    
+    opcode->Load(address, entry.opcode);
+
+    entry.instruction = instructions->Decode(opcode);
+    if (entry.instruction != nullptr)
+    {
+        entry.bytes = entry.instruction->bytes;
+        entry.cycles = entry.instruction->cycles;
+        entry.instruction->Resolve(opcode, registers, entry.operands);
+    }
+}
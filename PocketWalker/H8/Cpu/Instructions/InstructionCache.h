@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "Instruction.h"
+
+class InstructionTable;
+class Memory;
+class Opcode;
+class Registers;
+
+struct CachedInstruction
+{
+    Instruction* instruction = nullptr;
+    uint8_t bytes = 0;
+    uint8_t cycles = 0;
+    uint8_t opcode[8] = {};
+    InstructionOperands operands;
+};
+
+// predecoded instructions for the rom region, keyed by pc
+class InstructionCache
+{
+public:
+    InstructionCache(Memory* ram, InstructionTable* instructions, Registers* registers);
+
+    const CachedInstruction* Fetch(uint16_t address, Opcode* opcode);
+    void Invalidate(uint16_t address, size_t size);
+    void Clear();
+
+    uint32_t generation = 0;
+
+    static constexpr uint16_t CODE_END = 0xC000;
+
+private:
+    static constexpr size_t PAGE_SHIFT = 8;
+    static constexpr size_t PAGE_SIZE = 1 << PAGE_SHIFT;
+    static constexpr size_t PAGE_COUNT = CODE_END >> PAGE_SHIFT;
+
+    void Fill(CachedInstruction& entry, uint16_t address, Opcode* opcode) const;
+    
+    Memory* ram;
+    InstructionTable* instructions;
+    Registers* registers;
+
+    // made the first time code on them runs, so a cpu only holds entries for the code it executes
+    std::array<std::unique_ptr<CachedInstruction[]>, PAGE_COUNT> pages;
+    CachedInstruction uncached;
+};
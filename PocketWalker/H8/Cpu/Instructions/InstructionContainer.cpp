@@ -24,21 +24,26 @@ Instruction* InstructionContainer::Execute(Cpu* cpu)
         return instruction->parentContainer->Execute(cpu);
     }
 
-    const uint16_t preExecuteLocation = cpu->registers->pc;
-    if (instruction->execute != nullptr)
-    {
-        instruction->execute(cpu);
-    }
-    
-    cpu->registers->pc += instruction->bytes;
+    instruction->Resolve(cpu->opcodes, cpu->registers, cpu->decodedOperands);
+    instruction->Run(cpu, cpu->decodedOperands);
 
-    if (instruction->postExecute != nullptr)
+    return instruction;
+}
+
+Instruction* InstructionContainer::Decode(Opcode* opcode)
+{
+    const uint32_t firstValue = firstPredicate(opcode);
+    const uint32_t secondValue = secondPredicate(opcode);
+
+    Instruction* instruction = GetInstruction(firstValue, secondValue);
+    if (instruction == nullptr) instruction = GetPatternInstruction(firstValue, secondValue);
+    if (instruction == nullptr) return nullptr;
+
+    if (instruction->parentContainer != nullptr)
     {
-        instruction->postExecute(cpu);
+        return instruction->parentContainer->Decode(opcode);
     }
 
-    //std::println("0x{:04X} {}", preExecuteLocation, instruction->name);
-    
     return instruction;
 }
 
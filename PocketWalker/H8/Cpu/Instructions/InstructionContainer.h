@@ -41,6 +41,7 @@ public:
     }
 
     Instruction* Execute(Cpu* cpu);
+    Instruction* Decode(Opcode* opcode);
 
     void Register(uint32_t first, uint32_t second, const Instruction& instruction);
     void Register(uint32_t first, uint32_t second, InstructionContainer* container);
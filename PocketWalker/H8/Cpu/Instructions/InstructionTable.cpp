@@ -3,10 +3,574 @@
 #include <format>
 #include <stdexcept>
 #include <print>
+#include <type_traits>
 
 #include "../Components/Opcode.h"
 #include "../Cpu.h"
 
+namespace
+{
+    // Rs in bH, Rd in bL
+    template<typename T>
+    struct RegisterOperands
+    {
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            operands.source = registers->Register<T>(opcode->bH());
+            operands.destination = registers->Register<T>(opcode->bL());
+        }
+        
+        static T Source(const Cpu* cpu) { return *static_cast<const T*>(cpu->operands->source); }
+        static T* Destination(const Cpu* cpu) { return static_cast<T*>(cpu->operands->destination); }
+    };
+
+    // #xx:8 with Rd in aL, #xx:16 and #xx:32 with Rd in bL
+    template<typename T>
+    struct ImmediateOperands
+    {
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            if constexpr (sizeof(T) == 1)
+            {
+                operands.immediate = opcode->b();
+                operands.destination = registers->Register<T>(opcode->aL());
+            }
+            else
+            {
+                if constexpr (sizeof(T) == 2)
+                    operands.immediate = opcode->cd();
+                else
+                    operands.immediate = opcode->cd() << 16 | opcode->ef();
+                
+                operands.destination = registers->Register<T>(opcode->bL());
+            }
+        }
+        
+        static T Source(const Cpu* cpu) { return static_cast<T>(cpu->operands->immediate); }
+        static T* Destination(const Cpu* cpu) { return static_cast<T*>(cpu->operands->destination); }
+    };
+
+    // Rd in bL
+    template<typename T>
+    struct UnaryOperands
+    {
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            operands.destination = registers->Register<T>(opcode->bL());
+        }
+
+        static T* Destination(const Cpu* cpu) { return static_cast<T*>(cpu->operands->destination); }
+    };
+
+    // Rs in bH, Rd in bL at twice the width of Rs
+    template<typename T>
+    struct ExtendedOperands
+    {
+        using Wide = std::conditional_t<sizeof(T) == 1, uint16_t, uint32_t>;
+
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            operands.source = registers->Register<T>(opcode->bH());
+            operands.destination = registers->Register<Wide>(opcode->bL());
+        }
+
+        static T Source(const Cpu* cpu) { return *static_cast<const T*>(cpu->operands->source); }
+        static Wide* Destination(const Cpu* cpu) { return static_cast<Wide*>(cpu->operands->destination); }
+    };
+
+    // memory forms keep the data register in destination and the address register in source whichever way the data
+    // moves, the long forms sit behind the 01 00 prefix so everything is a word further on
+
+    // ERn in bH, Rn in bL
+    template<typename T>
+    struct IndirectOperands
+    {
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            const uint8_t fields = sizeof(T) == 4 ? opcode->d() : opcode->b();
+            operands.source = registers->Register32(fields >> 4);
+            operands.destination = registers->Register<T>(fields & 0xF);
+        }
+
+        static T* Register(const Cpu* cpu) { return static_cast<T*>(cpu->operands->destination); }
+        static uint32_t* AddressRegister(const Cpu* cpu) { return static_cast<uint32_t*>(cpu->operands->source); }
+        static uint32_t Address(const Cpu* cpu) { return *AddressRegister(cpu); }
+    };
+
+    // ERn in bH, Rn in bL, d:16 in cd
+    template<typename T>
+    struct DisplacementOperands
+    {
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            IndirectOperands<T>::Decode(opcode, registers, operands);
+            operands.displacement = static_cast<int16_t>(sizeof(T) == 4 ? opcode->ef() : opcode->cd());
+        }
+
+        static T* Register(const Cpu* cpu) { return static_cast<T*>(cpu->operands->destination); }
+        static uint32_t Address(const Cpu* cpu) { return *static_cast<const uint32_t*>(cpu->operands->source) + cpu->operands->displacement; }
+    };
+
+    // @aa:8 in b with Rn in aL, only the byte forms have it
+    template<typename T>
+    struct ShortAbsoluteOperands
+    {
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            operands.immediate = opcode->b() | 0xFF00;
+            operands.destination = registers->Register<T>(opcode->aL());
+        }
+
+        static T* Register(const Cpu* cpu) { return static_cast<T*>(cpu->operands->destination); }
+        static uint32_t Address(const Cpu* cpu) { return cpu->operands->immediate; }
+    };
+
+    // @aa:16 in cd with Rn in bL
+    template<typename T>
+    struct AbsoluteOperands
+    {
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            if constexpr (sizeof(T) == 4)
+            {
+                operands.immediate = opcode->ef();
+                operands.destination = registers->Register<T>(opcode->dL());
+            }
+            else
+            {
+                operands.immediate = opcode->cd();
+                operands.destination = registers->Register<T>(opcode->bL());
+            }
+        }
+
+        static T* Register(const Cpu* cpu) { return static_cast<T*>(cpu->operands->destination); }
+        static uint32_t Address(const Cpu* cpu) { return cpu->operands->immediate; }
+    };
+
+    // @aa:24 in cdef with Rn in bL, the long form's @aa:32 is in efgh
+    template<typename T>
+    struct ExtendedAbsoluteOperands
+    {
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            if constexpr (sizeof(T) == 4)
+            {
+                operands.immediate = opcode->ef() << 16 | opcode->gh();
+                operands.destination = registers->Register<T>(opcode->dL());
+            }
+            else
+            {
+                operands.immediate = opcode->cd() << 16 | opcode->ef();
+                operands.destination = registers->Register<T>(opcode->bL());
+            }
+        }
+
+        static T* Register(const Cpu* cpu) { return static_cast<T*>(cpu->operands->destination); }
+        static uint32_t Address(const Cpu* cpu) { return cpu->operands->immediate; }
+    };
+
+    // bit targets keep the whole #xx:3 nibble in immediate, the top bit picks the inverted BILD and BIST forms
+
+    // #xx:3 in bH, Rd in bL
+    struct RegisterBit
+    {
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            operands.immediate = opcode->bH();
+            operands.destination = registers->Register8(opcode->bL());
+        }
+
+        static uint8_t Read(const Cpu* cpu) { return *static_cast<const uint8_t*>(cpu->operands->destination); }
+        static void Write(const Cpu* cpu, const uint8_t value) { *static_cast<uint8_t*>(cpu->operands->destination) = value; }
+    };
+
+    // #xx:3 in dH, ERd in bH
+    struct IndirectBit
+    {
+        static void Decode(const Opcode* opcode, const Registers* registers, InstructionOperands& operands)
+        {
+            operands.immediate = opcode->dH();
+            operands.source = registers->Register32(opcode->bH());
+        }
+
+        static uint16_t Address(const Cpu* cpu) { return *static_cast<const uint32_t*>(cpu->operands->source); }
+        static uint8_t Read(const Cpu* cpu) { return cpu->ram->ReadByte(Address(cpu)); }
+        static void Write(const Cpu* cpu, const uint8_t value) { cpu->ram->WriteByte(Address(cpu), value); }
+    };
+
+    // #xx:3 in dH, @aa:8 in b, the address goes in displacement since immediate is taken
+    struct AbsoluteBit
+    {
+        static void Decode(const Opcode* opcode, const Registers*, InstructionOperands& operands)
+        {
+            operands.immediate = opcode->dH();
+            operands.displacement = opcode->b() | 0xFF00;
+        }
+
+        static uint8_t Read(const Cpu* cpu) { return cpu->ram->ReadByte(cpu->operands->displacement); }
+        static void Write(const Cpu* cpu, const uint8_t value) { cpu->ram->WriteByte(cpu->operands->displacement, value); }
+    };
+
+    // d:8 in b, d:16 in cd
+    template<typename T>
+    struct BranchOperands
+    {
+        static void Decode(const Opcode* opcode, const Registers*, InstructionOperands& operands)
+        {
+            if constexpr (sizeof(T) == 1)
+                operands.displacement = static_cast<T>(opcode->b());
+            else
+                operands.displacement = static_cast<T>(opcode->cd());
+        }
+    };
+
+    // branches, calls, returns and sleep end a block, what runs after them isn't the next instruction
+    Instruction ControlFlow(Instruction instruction)
+    {
+        instruction.isControlFlow = true;
+        return instruction;
+    }
+
+    template<typename T, template<typename> typename Operands>
+    void Mov(Cpu* cpu)
+    {
+        T* rd = Operands<T>::Destination(cpu);
+
+        *rd = Operands<T>::Source(cpu);
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T, template<typename> typename Operands>
+    void Add(Cpu* cpu)
+    {
+        const T rs = Operands<T>::Source(cpu);
+        T* rd = Operands<T>::Destination(cpu);
+
+        cpu->flags->Add(*rd, rs);
+        *rd += rs;
+    }
+
+    template<typename T, template<typename> typename Operands>
+    void Sub(Cpu* cpu)
+    {
+        const T rs = Operands<T>::Source(cpu);
+        T* rd = Operands<T>::Destination(cpu);
+
+        cpu->flags->Sub(*rd, rs);
+        *rd -= rs;
+    }
+
+    template<typename T, template<typename> typename Operands>
+    void Cmp(Cpu* cpu)
+    {
+        cpu->flags->Sub(*Operands<T>::Destination(cpu), Operands<T>::Source(cpu));
+    }
+
+    template<typename T, template<typename> typename Operands>
+    void And(Cpu* cpu)
+    {
+        T* rd = Operands<T>::Destination(cpu);
+
+        *rd &= Operands<T>::Source(cpu);
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T, template<typename> typename Operands>
+    void Or(Cpu* cpu)
+    {
+        T* rd = Operands<T>::Destination(cpu);
+
+        *rd |= Operands<T>::Source(cpu);
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T, template<typename> typename Operands>
+    void Xor(Cpu* cpu)
+    {
+        T* rd = Operands<T>::Destination(cpu);
+
+        *rd ^= Operands<T>::Source(cpu);
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T>
+    T ReadMemory(const Memory* ram, const uint32_t address)
+    {
+        if constexpr (sizeof(T) == 1)
+            return ram->ReadByte(address);
+        else if constexpr (sizeof(T) == 2)
+            return ram->ReadShort(address);
+        else
+            return ram->ReadInt(address);
+    }
+
+    template<typename T>
+    void WriteMemory(const Memory* ram, const uint32_t address, const T value)
+    {
+        if constexpr (sizeof(T) == 1)
+            ram->WriteByte(address, value);
+        else if constexpr (sizeof(T) == 2)
+            ram->WriteShort(address, value);
+        else
+            ram->WriteInt(address, value);
+    }
+
+    template<typename T, template<typename> typename Operands>
+    void Load(Cpu* cpu)
+    {
+        T* rd = Operands<T>::Register(cpu);
+
+        *rd = ReadMemory<T>(cpu->ram, Operands<T>::Address(cpu));
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T, template<typename> typename Operands>
+    void Store(Cpu* cpu)
+    {
+        const T* rs = Operands<T>::Register(cpu);
+
+        WriteMemory<T>(cpu->ram, Operands<T>::Address(cpu), *rs);
+        cpu->flags->Mov(*rs);
+    }
+
+    // @ERs+
+    template<typename T>
+    void LoadIncrement(Cpu* cpu)
+    {
+        T* rd = IndirectOperands<T>::Register(cpu);
+        uint32_t* ers = IndirectOperands<T>::AddressRegister(cpu);
+
+        *rd = ReadMemory<T>(cpu->ram, *ers);
+        *ers += sizeof(T);
+        cpu->flags->Mov(*rd);
+    }
+
+    // @-ERd
+    template<typename T>
+    void StoreDecrement(Cpu* cpu)
+    {
+        const T* rs = IndirectOperands<T>::Register(cpu);
+        uint32_t* erd = IndirectOperands<T>::AddressRegister(cpu);
+
+        *erd -= sizeof(T);
+        WriteMemory<T>(cpu->ram, *erd, *rs);
+        cpu->flags->Mov(*rs);
+    }
+
+    template<typename T, size_t Amount>
+    void Inc(Cpu* cpu)
+    {
+        T* rd = UnaryOperands<T>::Destination(cpu);
+
+        cpu->flags->Inc(*rd, Amount);
+        *rd += Amount;
+    }
+
+    template<typename T, size_t Amount>
+    void Dec(Cpu* cpu)
+    {
+        T* rd = UnaryOperands<T>::Destination(cpu);
+
+        cpu->flags->Dec(*rd, Amount);
+        *rd -= Amount;
+    }
+
+    // ADDS and SUBS leave the flags alone
+    template<size_t Amount>
+    void Adds(Cpu* cpu)
+    {
+        *UnaryOperands<uint32_t>::Destination(cpu) += Amount;
+    }
+
+    template<size_t Amount>
+    void Subs(Cpu* cpu)
+    {
+        *UnaryOperands<uint32_t>::Destination(cpu) -= Amount;
+    }
+
+    // shifts and rotates set carry themselves, so anything deferred has to land first
+    template<typename T>
+    void Shll(Cpu* cpu)
+    {
+        cpu->flags->Resolve();
+
+        T* rd = UnaryOperands<T>::Destination(cpu);
+        cpu->flags->carry = *rd & Flags::NegativeMask(sizeof(T) * 8);
+        *rd <<= 1;
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T>
+    void Shlr(Cpu* cpu)
+    {
+        cpu->flags->Resolve();
+
+        T* rd = UnaryOperands<T>::Destination(cpu);
+        cpu->flags->carry = *rd & 1;
+        *rd >>= 1;
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T>
+    void Shar(Cpu* cpu)
+    {
+        cpu->flags->Resolve();
+
+        T* rd = UnaryOperands<T>::Destination(cpu);
+        cpu->flags->carry = *rd & 1;
+        *rd = static_cast<T>(*rd >> 1 | (*rd & Flags::NegativeMask(sizeof(T) * 8)));
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T>
+    void Rotl(Cpu* cpu)
+    {
+        cpu->flags->Resolve();
+
+        T* rd = UnaryOperands<T>::Destination(cpu);
+        const bool msb = *rd >> (sizeof(T) * 8 - 1) & 1;
+        *rd = static_cast<T>(*rd << 1 | msb);
+
+        cpu->flags->carry = msb;
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T>
+    void Rotr(Cpu* cpu)
+    {
+        cpu->flags->Resolve();
+
+        T* rd = UnaryOperands<T>::Destination(cpu);
+        const bool lsb = *rd & 1;
+        *rd = static_cast<T>(*rd >> 1 | static_cast<T>(lsb) << (sizeof(T) * 8 - 1));
+
+        cpu->flags->carry = lsb;
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T>
+    void Not(Cpu* cpu)
+    {
+        T* rd = UnaryOperands<T>::Destination(cpu);
+
+        *rd = ~*rd;
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T>
+    void Neg(Cpu* cpu)
+    {
+        T* rd = UnaryOperands<T>::Destination(cpu);
+
+        cpu->flags->Sub(static_cast<T>(0), *rd);
+        if (*rd != Flags::NegativeMask(sizeof(T) * 8))
+        {
+            *rd = -*rd;
+        }
+    }
+
+    // the lower half of Rd times Rs
+    template<typename T>
+    void Mulxu(Cpu* cpu)
+    {
+        using Wide = typename ExtendedOperands<T>::Wide;
+        constexpr Wide lowerHalf = (static_cast<Wide>(1) << sizeof(T) * 8) - 1;
+        Wide* rd = ExtendedOperands<T>::Destination(cpu);
+
+        *rd = static_cast<Wide>((*rd & lowerHalf) * ExtendedOperands<T>::Source(cpu));
+    }
+
+    // remainder in the upper half of Rd, quotient in the lower
+    template<typename T>
+    void Divxu(Cpu* cpu)
+    {
+        using Wide = typename ExtendedOperands<T>::Wide;
+        constexpr size_t bits = sizeof(T) * 8;
+
+        cpu->flags->Resolve();
+
+        const T rs = ExtendedOperands<T>::Source(cpu);
+        Wide* rd = ExtendedOperands<T>::Destination(cpu);
+
+        const Wide quotient = *rd / rs;
+        const Wide remainder = *rd % rs;
+
+        *rd = static_cast<Wide>(remainder << bits | quotient);
+
+        cpu->flags->zero = quotient == 0;
+        cpu->flags->negative = quotient & Flags::NegativeMask(bits);
+    }
+
+    template<typename T>
+    void Extu(Cpu* cpu)
+    {
+        constexpr T lowerHalf = (static_cast<T>(1) << sizeof(T) * 4) - 1;
+        T* rd = UnaryOperands<T>::Destination(cpu);
+
+        *rd &= lowerHalf;
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename T>
+    void Exts(Cpu* cpu)
+    {
+        using LowerHalf = std::conditional_t<sizeof(T) == 2, int8_t, int16_t>;
+        T* rd = UnaryOperands<T>::Destination(cpu);
+
+        *rd = static_cast<T>(static_cast<LowerHalf>(*rd));
+        cpu->flags->Mov(*rd);
+    }
+
+    template<typename Target>
+    void Bset(Cpu* cpu)
+    {
+        Target::Write(cpu, Target::Read(cpu) | 1 << (cpu->operands->immediate & 0b111));
+    }
+
+    template<typename Target>
+    void Bclr(Cpu* cpu)
+    {
+        Target::Write(cpu, Target::Read(cpu) & ~(1 << (cpu->operands->immediate & 0b111)));
+    }
+
+    template<typename Target>
+    void Bnot(Cpu* cpu)
+    {
+        Target::Write(cpu, Target::Read(cpu) ^ 1 << (cpu->operands->immediate & 0b111));
+    }
+
+    template<typename Target>
+    void Btst(Cpu* cpu)
+    {
+        cpu->flags->Resolve();
+        cpu->flags->zero = !(Target::Read(cpu) >> (cpu->operands->immediate & 0b111) & 1);
+    }
+
+    template<typename Target>
+    void Bld(Cpu* cpu)
+    {
+        cpu->flags->Resolve();
+
+        if (cpu->operands->immediate & 0b1000)
+            throw std::runtime_error(std::format("Unimplemented BILD instruction at 0x{:04X}", cpu->registers->pc));
+
+        cpu->flags->carry = Target::Read(cpu) >> (cpu->operands->immediate & 0b111) & 1;
+    }
+
+    // BIST stores the inverted carry
+    template<typename Target>
+    void Bst(Cpu* cpu)
+    {
+        cpu->flags->Resolve();
+
+        const bool isOne = cpu->flags->carry != ((cpu->operands->immediate & 0b1000) != 0);
+        const uint8_t mask = 1 << (cpu->operands->immediate & 0b111);
+        const uint8_t value = Target::Read(cpu);
+
+        Target::Write(cpu, isOne ? value | mask : value & ~mask);
+    }
+}
+
 InstructionTable::InstructionTable() :
     aH_aL(InstructionContainer("aH/aL",
         [](const Opcode* opcode) { return opcode->aH(); },
@@ -32,30 +596,25 @@ InstructionTable::InstructionTable() :
                        "NOP",
                        2,
                        1,
-                       [](const Cpu* cpu){ }
+                       [](Cpu* cpu){ }
                    ));
 
     aH_aL.Register(0x0, 0x8, Instruction(
                        "ADD.B Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bH());
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-            
-                           cpu->flags->Add(*rd, *rs);
-
-                           *rd += *rs;
-                       }
+                       Add<uint8_t, RegisterOperands>,
+                       RegisterOperands<uint8_t>::Decode
                    ));
 
     aH_aL.Register(0x0, 0x7, Instruction(
                        "LDC.B #xx:8, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
+                           cpu->flags->Resolve();
+
                            const uint8_t imm = cpu->opcodes->b();
                            cpu->flags->ccr = imm;
                        }
@@ -65,156 +624,97 @@ InstructionTable::InstructionTable() :
                        "ADD.W Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bH());
-                           uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-            
-                           cpu->flags->Add(*rd, *rs);
-
-                           *rd += *rs;
-                       }
+                       Add<uint16_t, RegisterOperands>,
+                       RegisterOperands<uint16_t>::Decode
                    ));
 
     aH_aL.Register(0x0, 0xC, Instruction(
                        "MOV.B Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bH());
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-
-                           *rd = *rs;
-                           cpu->flags->Mov(*rd);
-                       }
+                       Mov<uint8_t, RegisterOperands>,
+                       RegisterOperands<uint8_t>::Decode
                    ));
 
     aH_aL.Register(0x0, 0xD, Instruction(
                        "MOV.W Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bH());
-                           uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-            
-                           *rd = *rs;
-                           cpu->flags->Mov(*rd);
-                       }
+                       Mov<uint16_t, RegisterOperands>,
+                       RegisterOperands<uint16_t>::Decode
                    ));
     
     aH_aL.Register(0x1, 0x4, Instruction(
                        "OR.B Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bH());
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-            
-                           *rd |= *rs;
-
-                           cpu->flags->Mov(*rd);
-                       }
+                       Or<uint8_t, RegisterOperands>,
+                       RegisterOperands<uint8_t>::Decode
                    ));
     
     aH_aL.Register(0x1, 0x5, Instruction(
                        "XOR.B Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bH());
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-            
-                           *rd ^= *rs;
-            
-                           cpu->flags->Mov(*rd);
-                       }
+                       Xor<uint8_t, RegisterOperands>,
+                       RegisterOperands<uint8_t>::Decode
                    ));
     
     aH_aL.Register(0x1, 0x6, Instruction(
                        "AND.B Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bH());
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-            
-                           *rd &= *rs;
-            
-                           cpu->flags->Mov(*rd);
-                       }
+                       And<uint8_t, RegisterOperands>,
+                       RegisterOperands<uint8_t>::Decode
                    ));
     
     aH_aL.Register(0x1, 0x8, Instruction(
                        "SUB.B Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bH());
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                           cpu->flags->Sub(*rd, *rs);
-
-                           *rd -= *rs;
-                       }
+                       Sub<uint8_t, RegisterOperands>,
+                       RegisterOperands<uint8_t>::Decode
                    ));
     
     aH_aL.Register(0x1, 0x9, Instruction(
                        "SUB.W Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bH());
-                           uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                           cpu->flags->Sub(*rd, *rs);
-
-                           *rd -= *rs;
-                       }
+                       Sub<uint16_t, RegisterOperands>,
+                       RegisterOperands<uint16_t>::Decode
                    ));
 
     aH_aL.Register(0x1, 0xC, Instruction(
                        "CMP.B Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bH());
-                           const uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-
-                           cpu->flags->Sub(*rd, *rs);
-                       }
+                       Cmp<uint8_t, RegisterOperands>,
+                       RegisterOperands<uint8_t>::Decode
                    ));
 
     aH_aL.Register(0x1, 0xD, Instruction(
                        "CMP.W Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bH());
-                           const uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                           cpu->flags->Sub(*rd, *rs);
-                       }
+                       Cmp<uint16_t, RegisterOperands>,
+                       RegisterOperands<uint16_t>::Decode
                    ));
 
     aH_aL.Register(0x1, 0xE, Instruction(
                        "SUBX Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
                            const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bH());
                            uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
 
-                           cpu->flags->Sub(*rd, static_cast<uint8_t>(*rs + cpu->flags->carry));
+                           cpu->flags->Resolve();
+                           const uint8_t value = *rs + cpu->flags->carry;
+
+                           cpu->flags->Sub(*rd, value);
             
-                           *rd -= *rs + cpu->flags->carry;
+                           *rd -= value;
                        }
                    ));
     
@@ -222,364 +722,348 @@ InstructionTable::InstructionTable() :
                        "MOV.B @aa:8, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->aL());
-                           const uint16_t address = cpu->opcodes->b() | 0xFF00;
-
-                           *rd = cpu->ram->ReadByte(address);
-           
-                           cpu->flags->Mov(*rd);
-                       }
+                       Load<uint8_t, ShortAbsoluteOperands>,
+                       ShortAbsoluteOperands<uint8_t>::Decode
                    ));
     
     aH_aL.Register({0x3}, {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                        "MOV.B Rs, @aa:8",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->aL());
-                           const uint16_t address = cpu->opcodes->b() | 0xFF00;
-
-                           cpu->ram->WriteByte(address, *rs);
-                           cpu->flags->Mov(*rs);
-                       }
+                       Store<uint8_t, ShortAbsoluteOperands>,
+                       ShortAbsoluteOperands<uint8_t>::Decode
                    ));
 
-    aH_aL.Register(0x4, 0x0, Instruction(
+    aH_aL.Register(0x4, 0x0, ControlFlow(Instruction(
                        "BRA d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           const int32_t disp = cpu->operands->displacement;
                            cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
 
-    aH_aL.Register(0x4, 0x2, Instruction(
+    aH_aL.Register(0x4, 0x2, ControlFlow(Instruction(
                        "BHI d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (!(cpu->flags->carry || cpu->flags->zero))
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
 
-    aH_aL.Register(0x4, 0x3, Instruction(
+    aH_aL.Register(0x4, 0x3, ControlFlow(Instruction(
                        "BLS d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (cpu->flags->carry || cpu->flags->zero)
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
 
-    aH_aL.Register(0x4, 0x4, Instruction(
+    aH_aL.Register(0x4, 0x4, ControlFlow(Instruction(
                        "BCC d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (!cpu->flags->carry)
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
 
-    aH_aL.Register(0x4, 0x5, Instruction(
+    aH_aL.Register(0x4, 0x5, ControlFlow(Instruction(
                        "BCS d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (cpu->flags->carry)
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
 
-    aH_aL.Register(0x4, 0x6, Instruction(
+    aH_aL.Register(0x4, 0x6, ControlFlow(Instruction(
                        "BNE d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (!cpu->flags->zero)
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
     
-    aH_aL.Register(0x4, 0x7, Instruction(
+    aH_aL.Register(0x4, 0x7, ControlFlow(Instruction(
                        "BEQ d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (cpu->flags->zero)
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
     
-    aH_aL.Register(0x4, 0xA, Instruction(
+    aH_aL.Register(0x4, 0xA, ControlFlow(Instruction(
                        "BPL d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (!cpu->flags->negative)
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
     
-    aH_aL.Register(0x4, 0xB, Instruction(
+    aH_aL.Register(0x4, 0xB, ControlFlow(Instruction(
                        "BMI d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (cpu->flags->negative)
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
     
-    aH_aL.Register(0x4, 0xC, Instruction(
+    aH_aL.Register(0x4, 0xC, ControlFlow(Instruction(
                        "BGE d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (cpu->flags->negative == cpu->flags->overflow)
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
     
-    aH_aL.Register(0x4, 0xD, Instruction(
+    aH_aL.Register(0x4, 0xD, ControlFlow(Instruction(
                        "BLT d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (cpu->flags->negative != cpu->flags->overflow)
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
     
-    aH_aL.Register(0x4, 0xE, Instruction(
+    aH_aL.Register(0x4, 0xE, ControlFlow(Instruction(
                        "BGT d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (!(cpu->flags->zero || (cpu->flags->negative != cpu->flags->overflow)))
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
     
-    aH_aL.Register(0x4, 0xF, Instruction(
+    aH_aL.Register(0x4, 0xF, ControlFlow(Instruction(
                        "BLE d:8",
                        2,
                        2,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           cpu->flags->Resolve();
+
+                           const int32_t disp = cpu->operands->displacement;
                            if (cpu->flags->zero || (cpu->flags->negative != cpu->flags->overflow))
                                cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
     
     aH_aL.Register(0x5, 0x0, Instruction(
                        "MULXU.B Rs, Rd",
                        2,
                        1 + 12,
-                       [](const Cpu* cpu)
-                       {
-                           uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bH());
-                           uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                           *rd = (*rd & 0xFF) * *rs;
-           
-                       }
+                       Mulxu<uint8_t>,
+                       ExtendedOperands<uint8_t>::Decode
                    ));
     
     aH_aL.Register(0x5, 0x1, Instruction(
                        "DIVXU.B Rs, Rd",
                        2,
                        1 + 12,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bH());
-                           uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                           const uint16_t quotient = *rd / *rs;
-                           const uint16_t remainder = *rd % *rs;
-
-                           *rd = (remainder << 8) | quotient;
-
-                           cpu->flags->zero = quotient == 0;
-                           cpu->flags->negative = quotient & Flags::NegativeMask(8);
-           
-                       }
+                       Divxu<uint8_t>,
+                       ExtendedOperands<uint8_t>::Decode
                    ));
     
     aH_aL.Register(0x5, 0x2, Instruction(
                        "MULXU.W Rs, ERd",
                        2,
                        1 + 20,
-                       [](const Cpu* cpu)
-                       {
-                           const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bH());
-                           uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-
-                           *erd = (*erd & 0xFFFF) * (*rs);
-           
-                       }
+                       Mulxu<uint16_t>,
+                       ExtendedOperands<uint16_t>::Decode
                    ));
     
     aH_aL.Register(0x5, 0x3, Instruction(
                        "DIVXU.W Rs, ERd",
                        2,
                        1 + 20,
-                       [](const Cpu* cpu)
-                       {
-                           uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bH());
-                           uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-
-                           const uint32_t quotient = *erd / *rs;
-                           const uint32_t remainder = *erd % *rs;
-
-                           *erd = (remainder << 16) | quotient;
-
-                           cpu->flags->zero = quotient == 0;
-                           cpu->flags->negative = quotient & Flags::NegativeMask(16);
-           
-                       }
+                       Divxu<uint16_t>,
+                       ExtendedOperands<uint16_t>::Decode
                    ));
 
-    aH_aL.Register(0x5, 0x4, Instruction(
+    aH_aL.Register(0x5, 0x4, ControlFlow(Instruction(
                        "RTS",
                        2,
                        2 + 1 + 2,
                        nullptr,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
                            cpu->registers->pc = cpu->registers->PopStack();
                        }
-                   ));
+                   )));
     
-    aH_aL.Register(0x5, 0x5, Instruction(
+    aH_aL.Register(0x5, 0x5, ControlFlow(Instruction(
                        "BSR d:8",
                        2,
                        2 + 1,
                        nullptr,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
                            cpu->registers->PushStack();
             
-                           const int8_t disp = static_cast<int8_t>(cpu->opcodes->b());
+                           const int32_t disp = cpu->operands->displacement;
                            cpu->registers->pc += disp;
-                       }
-                   ));
+                       },
+                       BranchOperands<int8_t>::Decode
+                   )));
 
-    aH_aL.Register(0x5, 0x6, Instruction(
+    aH_aL.Register(0x5, 0x6, ControlFlow(Instruction(
                        "RTE",
                        2,
                        2 + 2 + 2,
                        nullptr,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
+                           cpu->flags->Resolve();
+
                            cpu->registers->pc = cpu->interrupts->savedAddress;
                            cpu->flags->ccr = cpu->interrupts->savedFlags;
                        }
-                   ));
+                   )));
     
     
-    aH_aL.Register(0x5, 0x9, Instruction(
+    aH_aL.Register(0x5, 0x9, ControlFlow(Instruction(
                        "JMP @ERn",
                        2,
                        2 + 2,
                        nullptr,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
                            const uint32_t* ern = cpu->registers->Register32(cpu->opcodes->bH());
                            cpu->registers->pc = *ern & 0xFFFF;
                        }   
-                   ));
+                   )));
     
-    aH_aL.Register(0x5, 0xA, Instruction(
+    aH_aL.Register(0x5, 0xA, ControlFlow(Instruction(
                        "JMP @aa:24",
                        4,
                        2 + 2,
                        nullptr,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
                            const uint32_t address = (cpu->opcodes->b() << 16) | cpu->opcodes->cd();
                            cpu->registers->pc = address;
                        }
-                   ));
+                   )));
     
-    aH_aL.Register(0x5, 0xD, Instruction(
+    aH_aL.Register(0x5, 0xD, ControlFlow(Instruction(
                        "JSR @ERn",
                        2,
                        2 + 1,
                        nullptr,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
                            cpu->registers->PushStack();
             
                            const uint32_t* ern = cpu->registers->Register32(cpu->opcodes->bH());
                            cpu->registers->pc = *ern & 0xFFFF;
                        }
-                   ));
+                   )));
     
-    aH_aL.Register(0x5, 0xE, Instruction(
+    aH_aL.Register(0x5, 0xE, ControlFlow(Instruction(
                        "JSR @aa:24",
                        4,
                        2 + 1 + 2,
                        nullptr,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
                            cpu->registers->PushStack();
             
                            const uint32_t address = (cpu->opcodes->b() << 16) | cpu->opcodes->cd();
                            cpu->registers->pc = address;
                        }
-                   ));
+                   )));
 
     aH_aL.Register(0x6, 0x4, Instruction(
                        "OR.W Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bH());
-                           uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                           *rd |= *rs;
-
-                           cpu->flags->Mov(*rd);
-                       }
+                       Or<uint16_t, RegisterOperands>,
+                       RegisterOperands<uint16_t>::Decode
                    ));
     
     aH_aL.Register(0x6, 0x0, Instruction(
                        "BSET Rn, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
+                       [](Cpu* cpu)
                        {
                            uint8_t* rn = cpu->registers->Register8(cpu->opcodes->bH());
                            uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
@@ -592,58 +1076,24 @@ InstructionTable::InstructionTable() :
                        "XOR.W Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bH());
-                           uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                           *rd ^= *rs;
-
-                           cpu->flags->Mov(*rd);
-                       }
+                       Xor<uint16_t, RegisterOperands>,
+                       RegisterOperands<uint16_t>::Decode
                    ));
 
     aH_aL.Register(0x6, 0x6, Instruction(
                        "AND.W Rs, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bH());
-                           uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                           *rd &= *rs;
-
-                           cpu->flags->Mov(*rd);
-                       }
+                       And<uint16_t, RegisterOperands>,
+                       RegisterOperands<uint16_t>::Decode
                    ));
 
     aH_aL.Register(0x6, 0x7, Instruction(
                        "BST #xx:3, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t imm = cpu->opcodes->bH() & 0b111;
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-
-                           bool isOne = cpu->flags->carry;
-            
-                           const bool isInverted = cpu->opcodes->bH() & 0b1000;
-                           if (isInverted)
-                           {
-                               isOne = !isOne;
-                           }
-            
-                           if (isOne)
-                           {
-                               *rd |= (1 << imm);
-                           }
-                           else
-                           {
-                               *rd &= ~(1 << imm);
-                           }
-                       }
+                       Bst<RegisterBit>,
+                       RegisterBit::Decode
                    ));
     
     
@@ -657,28 +1107,16 @@ InstructionTable::InstructionTable() :
                                     "MOV.B Rs, @ERd",
                                     2,
                                     1 + 1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bL());
-                                        uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-
-                                        cpu->ram->WriteByte(*erd, *rs);
-                                        cpu->flags->Mov(*rs);
-                                    }
+                                    Store<uint8_t, IndirectOperands>,
+                                    IndirectOperands<uint8_t>::Decode
                                 ));
 
             container->Register(false, 0, Instruction(
                                     "MOV.B @ERs, Rd",
                                     2,
                                     1 + 1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        uint32_t* ers = cpu->registers->Register32(cpu->opcodes->bH());
-                                        uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                                        *rd = cpu->ram->ReadByte(*ers);
-
-                                        cpu->flags->Mov(*rd);
-                                    }
+                                    Load<uint8_t, IndirectOperands>,
+                                    IndirectOperands<uint8_t>::Decode
                                 ));
         })
     );
@@ -694,28 +1132,16 @@ InstructionTable::InstructionTable() :
                                     "MOV.W Rs, @ERd",
                                     2,
                                     1 + 1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bL());
-                                        uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-
-                                        cpu->ram->WriteShort(*erd, *rs);
-                                        cpu->flags->Mov(*rs);
-                                    }
+                                    Store<uint16_t, IndirectOperands>,
+                                    IndirectOperands<uint16_t>::Decode
                                 ));
 
             container->Register(false, 0, Instruction(
                                     "MOV.W @ERs, Rd",
                                     2,
                                     1 + 1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        uint32_t* ers = cpu->registers->Register32(cpu->opcodes->bH());
-                                        uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                                        *rd = cpu->ram->ReadShort(*ers);
-
-                                        cpu->flags->Mov(*rd);
-                                    }
+                                    Load<uint16_t, IndirectOperands>,
+                                    IndirectOperands<uint16_t>::Decode
                                 ));
         })
     );
@@ -730,59 +1156,32 @@ InstructionTable::InstructionTable() :
                                     "MOV.B @aa:16, Rd",
                                     4,
                                     2+1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                                        const uint16_t address = cpu->opcodes->cd();
-                    
-                                        *rd = cpu->ram->ReadByte(address);
-
-                                        cpu->flags->Mov(*rd);
-                                    }
+                                    Load<uint8_t, AbsoluteOperands>,
+                                    AbsoluteOperands<uint8_t>::Decode
                                 ));
 
             container->Register(0x6A, 0x2, Instruction(
                                     "MOV.B @aa:24, Rd",
                                     4,
                                     2+1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                                        const uint32_t address = (cpu->opcodes->cd() << 16) | cpu->opcodes->ef();
-                    
-                                        *rd = cpu->ram->ReadByte(address);
-
-                                        cpu->flags->Mov(*rd);
-                                    }
+                                    Load<uint8_t, ExtendedAbsoluteOperands>,
+                                    ExtendedAbsoluteOperands<uint8_t>::Decode
                                 ));
             
             container->Register(0x6A, 0x8, Instruction(
                                     "MOV.B Rs, @aa:16",
                                     4,
                                     2+1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bL());
-                                        const uint16_t address = cpu->opcodes->cd();
-                                        cpu->ram->WriteByte(address, *rs);
-
-
-                                        cpu->flags->Mov(*rs);
-                                    }
+                                    Store<uint8_t, AbsoluteOperands>,
+                                    AbsoluteOperands<uint8_t>::Decode
                                 ));
             
             container->Register(0x6A, 0xA, Instruction(
                                     "MOV.B Rs, @aa:24",
                                     4,
                                     2+1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bL());
-                                        const uint32_t address = (cpu->opcodes->cd() << 16) | cpu->opcodes->ef();
-                                        cpu->ram->WriteByte(address, *rs);
-                   
-                                        cpu->flags->Mov(*rs);
-                                    }
+                                    Store<uint8_t, ExtendedAbsoluteOperands>,
+                                    ExtendedAbsoluteOperands<uint8_t>::Decode
                                 )); 
         })
     );
@@ -797,58 +1196,32 @@ InstructionTable::InstructionTable() :
                                     "MOV.W @aa:16, Rd",
                                     4,
                                     2+1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                                        const uint16_t address = cpu->opcodes->cd();
-                    
-                                        *rd = cpu->ram->ReadShort(address);
-
-                                        cpu->flags->Mov(*rd);
-                                    }
+                                    Load<uint16_t, AbsoluteOperands>,
+                                    AbsoluteOperands<uint16_t>::Decode
                                 ));
 
             container->Register(0x6B, 0x2, Instruction(
                                     "MOV.W @aa:24, Rd",
                                     4,
                                     2+1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                                        const uint32_t address = (cpu->opcodes->cd() << 16) | cpu->opcodes->ef();
-
-                                        *rd = cpu->ram->ReadShort(address);
-
-                                        cpu->flags->Mov(*rd);
-                                    }
+                                    Load<uint16_t, ExtendedAbsoluteOperands>,
+                                    ExtendedAbsoluteOperands<uint16_t>::Decode
                                 ));
             
             container->Register(0x6B, 0x8, Instruction(
                                     "MOV.W Rs, @aa:16",
                                     4,
                                     2+1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bL());
-                                        const uint16_t address = cpu->opcodes->cd();
-                                        cpu->ram->WriteShort(address, *rs);
-
-                                        cpu->flags->Mov(*rs);
-                                    }
+                                    Store<uint16_t, AbsoluteOperands>,
+                                    AbsoluteOperands<uint16_t>::Decode
                                 ));
             
             container->Register(0x6B, 0xA, Instruction(
                                     "MOV.W Rs, @aa:24",
                                     4,
                                     2+1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bL());
-                                        const uint32_t address = cpu->opcodes->cd() << 16 | cpu->opcodes->ef();
-                                        cpu->ram->WriteShort(address, *rs);
-                   
-                                        cpu->flags->Mov(*rs);
-                                    }
+                                    Store<uint16_t, ExtendedAbsoluteOperands>,
+                                    ExtendedAbsoluteOperands<uint16_t>::Decode
                                 )); 
         })
     );
@@ -863,32 +1236,16 @@ InstructionTable::InstructionTable() :
                                     "MOV.B Rs, @-ERd",
                                     2,
                                     1 + 1 + 2,
-                                    [](const Cpu* cpu)
-                                    {
-                                        const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bL());
-                                        uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-
-                                        *erd -= 1;
-
-                                        cpu->ram->WriteByte(*erd, *rs);
-                                        cpu->flags->Mov(*rs);
-                                    }
+                                    StoreDecrement<uint8_t>,
+                                    IndirectOperands<uint8_t>::Decode
                                 ));
 
             container->Register(false, 0, Instruction(
                                     "MOV.B @ERs+, Rd",
                                     2,
                                     1 + 1 + 2,
-                                    [](const Cpu* cpu)
-                                    {
-                                        uint32_t* ers = cpu->registers->Register32(cpu->opcodes->bH());
-                                        uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                    
-                                        *rd = cpu->ram->ReadByte(*ers);
-                                        *ers += 1;
-
-                                        cpu->flags->Mov(*rd);
-                                    }
+                                    LoadIncrement<uint8_t>,
+                                    IndirectOperands<uint8_t>::Decode
                                 ));
         })
     );
@@ -903,32 +1260,16 @@ InstructionTable::InstructionTable() :
                                     "MOV.W Rs, @-ERd",
                                     2,
                                     1 + 1 + 2,
-                                    [](const Cpu* cpu)
-                                    {
-                                        const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bL());
-                                        uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-
-                                        *erd -= 2;
-
-                                        cpu->ram->WriteShort(*erd, *rs);
-                                        cpu->flags->Mov(*rs);
-                                    }
+                                    StoreDecrement<uint16_t>,
+                                    IndirectOperands<uint16_t>::Decode
                                 ));
 
             container->Register(0x6D, false, Instruction(
                                     "MOV.W @ERs+, Rd",
                                     2,
                                     1 + 1 + 2,
-                                    [](const Cpu* cpu)
-                                    {
-                                        uint32_t* ers = cpu->registers->Register32(cpu->opcodes->bH());
-                                        uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                    
-                                        *rd = cpu->ram->ReadShort(*ers);
-                                        *ers += 2;
-                    
-                                        cpu->flags->Mov(*rd);
-                                    }
+                                    LoadIncrement<uint16_t>,
+                                    IndirectOperands<uint16_t>::Decode
                                 ));
         })
     );
@@ -943,35 +1284,16 @@ InstructionTable::InstructionTable() :
                                     "MOV.B Rs, @(d:16,ERd)",
                                     4,
                                     2 + 1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        const int16_t disp = cpu->opcodes->cd();
-                    
-                                        const uint8_t* rs = cpu->registers->Register8(cpu->opcodes->bL());
-                                        uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-
-                                        cpu->ram->WriteByte(*erd + disp, *rs);
-
-                                        cpu->flags->Mov(*rs);
-                                    }
+                                    Store<uint8_t, DisplacementOperands>,
+                                    DisplacementOperands<uint8_t>::Decode
                                 ));
 
             container->Register(false, 0, Instruction(
                                     "MOV.B @(d:16,ERs), Rd ",
                                     4,
                                     2 + 1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        const int16_t disp = cpu->opcodes->cd();
-
-                                        uint32_t* ers = cpu->registers->Register32(cpu->opcodes->bH());
-                                        uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-
-                                        *rd = cpu->ram->ReadByte(*ers + disp);
-
-                                        cpu->flags->Mov(*rd);
-                    
-                                    }
+                                    Load<uint8_t, DisplacementOperands>,
+                                    DisplacementOperands<uint8_t>::Decode
                                 ));
         })
     );
@@ -986,35 +1308,16 @@ InstructionTable::InstructionTable() :
                                     "MOV.W Rs, @(d:16,ERd)",
                                     4,
                                     2 + 1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        const int16_t disp = cpu->opcodes->cd();
-                    
-                                        const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->bL());
-                                        uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-
-                                        cpu->ram->WriteShort(*erd + disp, *rs);
-
-                                        cpu->flags->Mov(*rs);
-                                    }
+                                    Store<uint16_t, DisplacementOperands>,
+                                    DisplacementOperands<uint16_t>::Decode
                                 ));
 
             container->Register(false, 0, Instruction(
                                     "MOV.W @(d:16,ERs), Rd ",
                                     4,
                                     2 + 1,
-                                    [](const Cpu* cpu)
-                                    {
-                                        const int16_t disp = cpu->opcodes->cd();
-
-                                        uint32_t* ers = cpu->registers->Register32(cpu->opcodes->bH());
-                                        uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                                        *rd = cpu->ram->ReadShort(*ers + disp);
-
-                                        cpu->flags->Mov(*rd);
-                    
-                                    }
+                                    Load<uint16_t, DisplacementOperands>,
+                                    DisplacementOperands<uint16_t>::Decode
                                 ));
         })
     );
@@ -1023,130 +1326,72 @@ InstructionTable::InstructionTable() :
                        "BSET #xx:3, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t imm = cpu->opcodes->bH() & 0b111;
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-
-                           *rd |= 1 << imm;
-                       }
+                       Bset<RegisterBit>,
+                       RegisterBit::Decode
                    ));
     
     aH_aL.Register(0x7, 0x3, Instruction(
                        "BTST #xx:3, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t imm = cpu->opcodes->bH() & 0b111;
-                           const uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-
-                           cpu->flags->zero = !((*rd >> imm) & 1);
-                       }
+                       Btst<RegisterBit>,
+                       RegisterBit::Decode
                    ));
 
     aH_aL.Register(0x7, 0x7, Instruction(
                        "BLD.B #xx:3, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           if (cpu->opcodes->bH() & 0b1000)
-                           {
-                               throw std::runtime_error(std::format("Unimplemented BILD instruction at 0x{:04X}", cpu->registers->pc));
-                           }
-           
-                           const uint8_t imm = cpu->opcodes->bH() & 0b111;
-                           const uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-
-                           cpu->flags->carry =(*rd >> imm) & 1;
-                       }
+                       Bld<RegisterBit>,
+                       RegisterBit::Decode
                    ));
     
     aH_aL.Register({0x8}, {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                        "ADD.B #xx:8, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t imm = cpu->opcodes->b();
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->aL());
-
-                           cpu->flags->Add(*rd, imm);
-
-                           *rd += imm;
-                       }
+                       Add<uint8_t, ImmediateOperands>,
+                       ImmediateOperands<uint8_t>::Decode
                    ));
     
     aH_aL.Register({0xA}, {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                        "CMP.B #xx:8, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t imm = cpu->opcodes->b();
-                           const uint8_t* rd = cpu->registers->Register8(cpu->opcodes->aL());
-
-                           cpu->flags->Sub(*rd, imm);
-                       }
+                       Cmp<uint8_t, ImmediateOperands>,
+                       ImmediateOperands<uint8_t>::Decode
                    ));
 
     aH_aL.Register({0xC}, {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                        "OR.B #xx:8, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t imm = cpu->opcodes->b();
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->aL());
-
-                           *rd |= imm;
-
-                           cpu->flags->Mov(*rd);
-                       }
+                       Or<uint8_t, ImmediateOperands>,
+                       ImmediateOperands<uint8_t>::Decode
                    ));
 
     aH_aL.Register({0xD}, {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                        "XOR.B #xx:8, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t imm = cpu->opcodes->b();
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->aL());
-
-                           *rd ^= imm;
-
-                           cpu->flags->Mov(*rd);
-                       }
+                       Xor<uint8_t, ImmediateOperands>,
+                       ImmediateOperands<uint8_t>::Decode
                    ));
 
     aH_aL.Register({0xE}, {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                        "AND.B #xx:8, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t imm = cpu->opcodes->b();
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->aL());
-
-                           *rd &= imm;
-                           cpu->flags->Mov(*rd);
-                       }
+                       And<uint8_t, ImmediateOperands>,
+                       ImmediateOperands<uint8_t>::Decode
                    ));
 
     aH_aL.Register({0xF}, {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                        "MOV.B #xx:8, Rd",
                        2,
                        1,
-                       [](const Cpu* cpu)
-                       {
-                           const uint8_t imm = cpu->opcodes->b();
-                           uint8_t* rd = cpu->registers->Register8(cpu->opcodes->aL());
-
-                           *rd = imm;
-                           cpu->flags->Mov(*rd);
-                       }
+                       Mov<uint8_t, ImmediateOperands>,
+                       ImmediateOperands<uint8_t>::Decode
                    ));
 
     aHaL_bH.Register(0x1, 0x0, new InstructionContainer(
@@ -1165,30 +1410,16 @@ InstructionTable::InstructionTable() :
                                             "MOV.L ERs, @ERd",
                                             4,
                                             2 + 2,
-                                            [](const Cpu* cpu)
-                                            {
-                                                const uint32_t* ers = cpu->registers->Register32(cpu->opcodes->dL());
-                                                const uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dH());
-
-                                                cpu->ram->WriteInt(*erd, *ers);
-
-                                                cpu->flags->Mov(*ers);
-                                            }
+                                            Store<uint32_t, IndirectOperands>,
+                                            IndirectOperands<uint32_t>::Decode
                                         ));
 
                     container->Register(false, 0, Instruction(
                                             "MOV.L @ERs, ERd",
                                             4,
                                             2 + 2,
-                                            [](const Cpu* cpu)
-                                            {
-                                                const uint32_t* ers = cpu->registers->Register32(cpu->opcodes->dH());
-                                                uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dL());
-                            
-                                                *erd = cpu->ram->ReadInt(*ers);
-                            
-                                                cpu->flags->Mov(*erd);
-                                            }
+                                            Load<uint32_t, IndirectOperands>,
+                                            IndirectOperands<uint32_t>::Decode
                                         ));
                 }
             ));
@@ -1203,61 +1434,32 @@ InstructionTable::InstructionTable() :
                                             "MOV.L @aa:16, ERd",
                                             6,
                                             3 + 2,
-                                            [](const Cpu* cpu)
-                                            {
-                                                const uint16_t address = cpu->opcodes->ef();
-                                                uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dL());
-                          
-                                                *erd = cpu->ram->ReadInt(address);
-
-                                                cpu->flags->Mov(*erd);
-                                            }
+                                            Load<uint32_t, AbsoluteOperands>,
+                                            AbsoluteOperands<uint32_t>::Decode
                                         ));
 
                     container->Register(0x2, 0, Instruction(
                                             "MOV.L @aa:32, ERd",
                                             8,
                                             3 + 2,
-                                            [](const Cpu* cpu)
-                                            {
-                                                const uint32_t address = (cpu->opcodes->ef() << 16) | cpu->opcodes->gh();
-                                                uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dL());
-                          
-                                                *erd = cpu->ram->ReadInt(address);
-
-                                                cpu->flags->Mov(*erd);
-                                            }
+                                            Load<uint32_t, ExtendedAbsoluteOperands>,
+                                            ExtendedAbsoluteOperands<uint32_t>::Decode
                                         ));
                     
                     container->Register(0x8, 0, Instruction(
                                             "MOV.L ERs, @aa:16",
                                             6,
                                             3 + 2,
-                                            [](const Cpu* cpu)
-                                            {
-                                                const uint32_t* ers = cpu->registers->Register32(cpu->opcodes->dL());
-                                                const uint16_t address = cpu->opcodes->ef();
-
-                                                cpu->ram->WriteInt(address, *ers);
-
-                                                cpu->flags->Mov(*ers);
-                                            }
+                                            Store<uint32_t, AbsoluteOperands>,
+                                            AbsoluteOperands<uint32_t>::Decode
                                         ));
 
                     container->Register(0xA, 0, Instruction(
                                             "MOV.L ERs, @aa:32",
                                             8,
                                             3 + 2,
-                                            [](const Cpu* cpu)
-                                            {
-                                                const uint32_t* ers = cpu->registers->Register32(cpu->opcodes->dL());
-                                                const uint32_t address = (cpu->opcodes->ef() << 16) | cpu->opcodes->gh();
-
-                                                cpu->ram->WriteInt(address, *ers);
-
-                            
-                                                cpu->flags->Mov(*ers);
-                                            }
+                                            Store<uint32_t, ExtendedAbsoluteOperands>,
+                                            ExtendedAbsoluteOperands<uint32_t>::Decode
                                         ));
                 }
             ));
@@ -1272,34 +1474,16 @@ InstructionTable::InstructionTable() :
                                             "MOV.L ERs, @-ERd",
                                             4,
                                             2 + 2 + 2,
-                                            [](const Cpu* cpu)
-                                            {
-                                                const uint32_t* ers = cpu->registers->Register32(cpu->opcodes->dL());
-                                                uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dH());
-
-                                                *erd -= 4;
-
-                                                cpu->ram->WriteInt(*erd, *ers);
-
-                                                cpu->flags->Mov(*ers);
-                                            }
+                                            StoreDecrement<uint32_t>,
+                                            IndirectOperands<uint32_t>::Decode
                                         ));
 
                     container->Register(false, 0, Instruction(
                                             "MOV.L @ERs+, ERd",
                                             4,
                                             2 + 2 + 2,
-                                            [](const Cpu* cpu)
-                                            {
-                                                uint32_t* ers = cpu->registers->Register32(cpu->opcodes->dH());
-                                                uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dL());
-                            
-                                                *erd = cpu->ram->ReadInt(*ers);
-                            
-                                                *ers += 4;
-                            
-                                                cpu->flags->Mov(*erd);
-                                            }
+                                            LoadIncrement<uint32_t>,
+                                            IndirectOperands<uint32_t>::Decode
                                         ));
                 }
             ));
@@ -1314,41 +1498,23 @@ InstructionTable::InstructionTable() :
                                             "MOV.L ERs, @(d:16,ERd)",
                                             6,
                                             3 + 2,
-                                            [](const Cpu* cpu)
-                                            {
-                                                const int16_t disp = cpu->opcodes->ef();
-                    
-                                                const uint32_t* ers = cpu->registers->Register32(cpu->opcodes->dL());
-                                                const uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dH());
-
-                                                cpu->ram->WriteInt(*erd + disp, *ers);
-
-                                                cpu->flags->Mov(*ers);
-                                            }
+                                            Store<uint32_t, DisplacementOperands>,
+                                            DisplacementOperands<uint32_t>::Decode
                                         ));
 
                     container->Register(false, 0, Instruction(
                                             "MOV.L @(d:16,ERs), ERd",
                                             6,
                                             3 + 2 ,
-                                            [](const Cpu* cpu)
-                                            {
-                                                const int16_t disp = cpu->opcodes->ef();
-
-                                                const uint32_t* ers = cpu->registers->Register32(cpu->opcodes->dH());
-                                                uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dL());
-
-                                                *erd = cpu->ram->ReadInt(*ers + disp);
-
-                                                cpu->flags->Mov(*erd);
-                                            }
+                                            Load<uint32_t, DisplacementOperands>,
+                                            DisplacementOperands<uint32_t>::Decode
                                         ));
                 }
             ));
         }
     ));
 
-    aHaL_bH.Register(0x1, 0x8, Instruction(
+    aHaL_bH.Register(0x1, 0x8, ControlFlow(Instruction(
                          "SLEEP",
                          2,
                          1,
@@ -1356,273 +1522,158 @@ InstructionTable::InstructionTable() :
                          {
                              cpu->sleeping = true;
                          }
-                     ));
+                     )));
 
     aHaL_bH.Register(0xA, 0x0, Instruction(
                          "INC.B Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                             cpu->flags->Inc(*rd, 1);
-        
-                             *rd += 1;
-                         }
+                         Inc<uint8_t, 1>,
+                         UnaryOperands<uint8_t>::Decode
                      ));
 
     aHaL_bH.Register({0xA}, {0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                          "ADD.L ERs, ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             const uint32_t* ers = cpu->registers->Register32(cpu->opcodes->bH());
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-            
-                             cpu->flags->Add(*erd, *ers);
-
-                             *erd += *ers;
-                         }
+                         Add<uint32_t, RegisterOperands>,
+                         RegisterOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register(0xB, 0x0, Instruction(
                          "ADDS #1, ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-                             *erd += 1;
-                         }
+                         Adds<1>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register(0xB, 0x5, Instruction(
                          "INC.W #1, Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                             cpu->flags->Inc(*rd, 1);
-        
-                             *rd += 1;
-                         }
+                         Inc<uint16_t, 1>,
+                         UnaryOperands<uint16_t>::Decode
                      ));
 
     aHaL_bH.Register(0xB, 0x7, Instruction(
                          "INC.L #1, Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* rd = cpu->registers->Register32(cpu->opcodes->bL());
-                             cpu->flags->Inc(*rd, 1);
-        
-                             *rd += 1;
-                         }
+                         Inc<uint32_t, 1>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register(0xB, 0x8, Instruction(
                          "ADDS #2, ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-                             *erd += 2;
-                         }
+                         Adds<2>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register(0xB, 0x9, Instruction(
                          "ADDS #4, ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-                             *erd += 4;
-                         }
+                         Adds<4>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register(0xB, 0xD, Instruction(
                          "INC.W #2, Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                             cpu->flags->Inc(*rd, 2);
-        
-                             *rd += 2;
-                         }
+                         Inc<uint16_t, 2>,
+                         UnaryOperands<uint16_t>::Decode
                      ));
     
     aHaL_bH.Register({0xF}, {0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                          "MOV.L ERs, ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-                             uint32_t* ers = cpu->registers->Register32(cpu->opcodes->bH());
-
-                             *erd = *ers;
-
-                             cpu->flags->Mov(*erd);
-                         }
+                         Mov<uint32_t, RegisterOperands>,
+                         RegisterOperands<uint32_t>::Decode
                      ));
     
     aHaL_bH.Register(0x10, 0x0, Instruction(
                          "SHLL.B Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                             cpu->flags->carry = *rd & Flags::NegativeMask(8);
-                             *rd <<= 1;
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Shll<uint8_t>,
+                         UnaryOperands<uint8_t>::Decode
                      ));
     
     aHaL_bH.Register(0x10, 0x1, Instruction(
                          "SHLL.W Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                             cpu->flags->carry = *rd & Flags::NegativeMask(16);
-                             *rd <<= 1;
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Shll<uint16_t>,
+                         UnaryOperands<uint16_t>::Decode
                      ));
     
     aHaL_bH.Register(0x10, 0x3, Instruction(
                          "SHLL.L ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* rd = cpu->registers->Register32(cpu->opcodes->bL());
-                             cpu->flags->carry = *rd & Flags::NegativeMask(32);
-                             *rd <<= 1;
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Shll<uint32_t>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
     
     aHaL_bH.Register(0x11, 0x0, Instruction(
                          "SHLR.B Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                             cpu->flags->carry = *rd & 1;
-                             *rd >>= 1;
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Shlr<uint8_t>,
+                         UnaryOperands<uint8_t>::Decode
                      ));
     
     aHaL_bH.Register(0x11, 0x1, Instruction(
                          "SHLR.W Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                             cpu->flags->carry = *rd & 1;
-                             *rd >>= 1;
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Shlr<uint16_t>,
+                         UnaryOperands<uint16_t>::Decode
                      ));
     
     aHaL_bH.Register(0x11, 0x3, Instruction(
                          "SHLR.L ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* rd = cpu->registers->Register32(cpu->opcodes->bL());
-                             cpu->flags->carry = *rd & 1;
-                             *rd >>= 1;
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Shlr<uint32_t>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
     
     aHaL_bH.Register(0x11, 0x9, Instruction(
                          "SHAR.W Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-           
-                             cpu->flags->carry = *rd & 1;
-           
-                             *rd = (*rd >> 1) | (*rd & Flags::NegativeMask(16));
-           
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Shar<uint16_t>,
+                         UnaryOperands<uint16_t>::Decode
                      ));
     
     aHaL_bH.Register(0x11, 0xB, Instruction(
                          "SHAR.L Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* rd = cpu->registers->Register32(cpu->opcodes->bL());
-           
-                             cpu->flags->carry = *rd & 1;
-           
-                             *rd = (*rd >> 1) | (*rd & Flags::NegativeMask(32));
-           
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Shar<uint32_t>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
     
     aHaL_bH.Register(0x12, 0x8, Instruction(
                          "ROTL.B Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-
-                             const uint8_t msb = (*rd >> 7) & 1;
-                             *rd = (*rd << 1) | msb;
-           
-                             cpu->flags->carry = msb;
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Rotl<uint8_t>,
+                         UnaryOperands<uint8_t>::Decode
                      ));
     
     aHaL_bH.Register(0x12, 0x9, Instruction(
                          "ROTL.W Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                             const uint8_t msb = (*rd >> 15) & 1;
-                             *rd = (*rd << 1) | msb;
-           
-                             cpu->flags->carry = msb;
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Rotl<uint16_t>,
+                         UnaryOperands<uint16_t>::Decode
                      ));
 
     
@@ -1630,125 +1681,64 @@ InstructionTable::InstructionTable() :
                          "ROTR.B Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-
-                             const uint8_t lsb = *rd & 1;
-                             *rd = (*rd >> 1) | (lsb << 7);
-           
-                             cpu->flags->carry = lsb;
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Rotr<uint8_t>,
+                         UnaryOperands<uint8_t>::Decode
                      ));
     
     aHaL_bH.Register(0x17, 0x0, Instruction(
                          "NOT.B Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                             *rd = ~*rd;
-
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Not<uint8_t>,
+                         UnaryOperands<uint8_t>::Decode
                      ));
     
     aHaL_bH.Register(0x17, 0x5, Instruction(
                          "EXTU.W Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                             *rd &= 0xFF;
-
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Extu<uint16_t>,
+                         UnaryOperands<uint16_t>::Decode
                      ));
 
     aHaL_bH.Register(0x17, 0x7, Instruction(
                          "EXTU.L ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-                             *erd &= 0xFFFF;
-
-                             cpu->flags->Mov(*erd);
-
-                         }
+                         Extu<uint32_t>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register(0x17, 0x8, Instruction(
                          "NEG.B",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                             cpu->flags->Sub(static_cast<uint8_t>(0), *rd);
-            
-                             if (*rd != Flags::NegativeMask(8))
-                             {
-                                 *rd = -*rd;
-                             }
-            
-                         }
+                         Neg<uint8_t>,
+                         UnaryOperands<uint8_t>::Decode
                      ));
 
     aHaL_bH.Register(0x17, 0x9, Instruction(
                          "NEG.W Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                             cpu->flags->Sub(static_cast<uint16_t>(0), *rd);
-            
-                             if (*rd != Flags::NegativeMask(16))
-                             {
-                                 *rd = -*rd;
-                             }
-            
-                         }
+                         Neg<uint16_t>,
+                         UnaryOperands<uint16_t>::Decode
                      ));
     
     aHaL_bH.Register(0x17, 0xD, Instruction(
                          "EXTS.W Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                             const int8_t firstPart = static_cast<int8_t>(*rd & 0xFF);
-                             *rd = static_cast<int16_t>(firstPart);
-
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Exts<uint16_t>,
+                         UnaryOperands<uint16_t>::Decode
                      ));
     
     aHaL_bH.Register(0x17, 0xF, Instruction(
                          "EXTS.L Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* rd = cpu->registers->Register32(cpu->opcodes->bL());
-
-                             const int16_t firstPart = static_cast<int16_t>(*rd & 0xFFFF);
-                             *rd = static_cast<int32_t>(firstPart);
-
-                             cpu->flags->Mov(*rd);
-
-                         }
+                         Exts<uint32_t>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
     
 
@@ -1756,338 +1746,273 @@ InstructionTable::InstructionTable() :
                          "DEC.B ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint8_t* rd = cpu->registers->Register8(cpu->opcodes->bL());
-                             cpu->flags->Dec(*rd, 1);
-           
-                             *rd -= 1;
-
-                         }
+                         Dec<uint8_t, 1>,
+                         UnaryOperands<uint8_t>::Decode
                      ));
     
     aHaL_bH.Register({0x1A}, {0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                          "SUB.L ERs, ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* ers = cpu->registers->Register32(cpu->opcodes->bH());
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-                             cpu->flags->Sub(*erd, *ers);
-
-                             *erd -= *ers;
-           
-                         }
+                         Sub<uint32_t, RegisterOperands>,
+                         RegisterOperands<uint32_t>::Decode
                      ));
     
     aHaL_bH.Register(0x1B, 0x5, Instruction(
                          "DEC.W #1, Rd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-                             cpu->flags->Dec(*rd, 1);
-           
-                             *rd -= 1;
-                         }
+                         Dec<uint16_t, 1>,
+                         UnaryOperands<uint16_t>::Decode
                      ));
     
     aHaL_bH.Register(0x1B, 0x8, Instruction(
                          "SUBS #2, ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-                             *erd -= 2;
-                         }
+                         Subs<2>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register(0x1B, 0x9, Instruction(
                          "SUBS #4, ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-                             *erd -= 4;
-                         }
+                         Subs<4>,
+                         UnaryOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register({0x1F}, {0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF}, Instruction(
                          "CMP.L ERs, ERd",
                          2,
                          1,
-                         [](const Cpu* cpu)
-                         {
-                             uint32_t* ers = cpu->registers->Register32(cpu->opcodes->bH());
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-
-                             cpu->flags->Sub(*erd, *ers);
-                         }
+                         Cmp<uint32_t, RegisterOperands>,
+                         RegisterOperands<uint32_t>::Decode
                      ));
 
-    aHaL_bH.Register(0x58, 0x2, Instruction(
+    aHaL_bH.Register(0x58, 0x2, ControlFlow(Instruction(
                          "BHI d:16",
                          4,
                          2 + 2,
-                         [](const Cpu* cpu)
+                         [](Cpu* cpu)
                          {
-                             const int16_t disp = static_cast<int16_t>(cpu->opcodes->cd());
+                             cpu->flags->Resolve();
+
+                             const int32_t disp = cpu->operands->displacement;
                              if (!(cpu->flags->carry || cpu->flags->zero))
                                  cpu->registers->pc += disp;
-                         }
-                     ));
+                         },
+                         BranchOperands<int16_t>::Decode
+                     )));
 
-    aHaL_bH.Register(0x58, 0x3, Instruction(
+    aHaL_bH.Register(0x58, 0x3, ControlFlow(Instruction(
                          "BLS d:16",
                          4,
                          2 + 2,
-                         [](const Cpu* cpu)
+                         [](Cpu* cpu)
                          {
-                             const int16_t disp = static_cast<int16_t>(cpu->opcodes->cd());
+                             cpu->flags->Resolve();
+
+                             const int32_t disp = cpu->operands->displacement;
                              if (cpu->flags->carry || cpu->flags->zero)
                                  cpu->registers->pc += disp;
-                         }
-                     ));
+                         },
+                         BranchOperands<int16_t>::Decode
+                     )));
 
-    aHaL_bH.Register(0x58, 0x4, Instruction(
+    aHaL_bH.Register(0x58, 0x4, ControlFlow(Instruction(
                          "BCC d:16",
                          4,
                          2 + 2,
-                         [](const Cpu* cpu)
+                         [](Cpu* cpu)
                          {
-                             const int16_t disp = static_cast<int16_t>(cpu->opcodes->cd());
+                             cpu->flags->Resolve();
+
+                             const int32_t disp = cpu->operands->displacement;
                              if (!cpu->flags->carry)
                                  cpu->registers->pc += disp;
-                         }
-                     ));
+                         },
+                         BranchOperands<int16_t>::Decode
+                     )));
 
-    aHaL_bH.Register(0x58, 0x5, Instruction(
+    aHaL_bH.Register(0x58, 0x5, ControlFlow(Instruction(
                          "BCS d:16",
                          4,
                          2 + 2,
-                         [](const Cpu* cpu)
+                         [](Cpu* cpu)
                          {
-                             const int16_t disp = static_cast<int16_t>(cpu->opcodes->cd());
+                             cpu->flags->Resolve();
+
+                             const int32_t disp = cpu->operands->displacement;
                              if (cpu->flags->carry)
                                  cpu->registers->pc += disp;
-                         }
-                     ));
+                         },
+                         BranchOperands<int16_t>::Decode
+                     )));
 
-    aHaL_bH.Register(0x58, 0x6, Instruction(
+    aHaL_bH.Register(0x58, 0x6, ControlFlow(Instruction(
                          "BNE d:16",
                          4,
                          2 + 2,
-                         [](const Cpu* cpu)
+                         [](Cpu* cpu)
                          {
-                             const int16_t disp = static_cast<int16_t>(cpu->opcodes->cd());
+                             cpu->flags->Resolve();
+
+                             const int32_t disp = cpu->operands->displacement;
                              if (!cpu->flags->zero)
                                  cpu->registers->pc += disp;
-                         }
-                     ));
+                         },
+                         BranchOperands<int16_t>::Decode
+                     )));
 
-    aHaL_bH.Register(0x58, 0x7, Instruction(
+    aHaL_bH.Register(0x58, 0x7, ControlFlow(Instruction(
                          "BEQ d:16",
                          4,
                          2 + 2,
-                         [](const Cpu* cpu)
+                         [](Cpu* cpu)
                          {
-                             const int16_t disp = static_cast<int16_t>(cpu->opcodes->cd());
+                             cpu->flags->Resolve();
+
+                             const int32_t disp = cpu->operands->displacement;
                              if (cpu->flags->zero)
                                  cpu->registers->pc += disp;
-                         }
-                     ));
+                         },
+                         BranchOperands<int16_t>::Decode
+                     )));
 
-    aHaL_bH.Register(0x58, 0xC, Instruction(
+    aHaL_bH.Register(0x58, 0xC, ControlFlow(Instruction(
                          "BGE d:16",
                          4,
                          2 + 2,
-                         [](const Cpu* cpu)
+                         [](Cpu* cpu)
                          {
-                             const int16_t disp = static_cast<int16_t>(cpu->opcodes->cd());
+                             cpu->flags->Resolve();
+
+                             const int32_t disp = cpu->operands->displacement;
                              if (cpu->flags->negative == cpu->flags->overflow)
                                  cpu->registers->pc += disp;
-                         }
-                     ));
+                         },
+                         BranchOperands<int16_t>::Decode
+                     )));
 
-    aHaL_bH.Register(0x58, 0xD, Instruction(
+    aHaL_bH.Register(0x58, 0xD, ControlFlow(Instruction(
                          "BLT d:16",
                          4,
                          2 + 2,
-                         [](const Cpu* cpu)
+                         [](Cpu* cpu)
                          {
-                             const int16_t disp = static_cast<int16_t>(cpu->opcodes->cd());
+                             cpu->flags->Resolve();
+
+                             const int32_t disp = cpu->operands->displacement;
                              if (cpu->flags->negative != cpu->flags->overflow)
                                  cpu->registers->pc += disp;
-                         }
-                     ));
+                         },
+                         BranchOperands<int16_t>::Decode
+                     )));
 
-    aHaL_bH.Register(0x58, 0xE, Instruction(
+    aHaL_bH.Register(0x58, 0xE, ControlFlow(Instruction(
                          "BGT d:16",
                          4,
                          2 + 2,
-                         [](const Cpu* cpu)
+                         [](Cpu* cpu)
                          {
-                             const int16_t disp = static_cast<int16_t>(cpu->opcodes->cd());
+                             cpu->flags->Resolve();
+
+                             const int32_t disp = cpu->operands->displacement;
                              if (!(cpu->flags->zero || (cpu->flags->negative != cpu->flags->overflow)))
                                  cpu->registers->pc += disp;
-                         }
-                     ));
+                         },
+                         BranchOperands<int16_t>::Decode
+                     )));
 
     aHaL_bH.Register(0x79, 0x0, Instruction(
                          "MOV.W #xx:16, Rd",
                          4,
                          2,
-                         [](const Cpu* cpu)
-                         {
-                             const uint16_t imm = cpu->opcodes->cd();
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                             *rd = imm;
-                             cpu->flags->Mov(imm);
-                         }
+                         Mov<uint16_t, ImmediateOperands>,
+                         ImmediateOperands<uint16_t>::Decode
                      ));
 
     aHaL_bH.Register(0x79, 0x1, Instruction(
                          "ADD.W #xx:16, Rd",
                          4,
                          2,
-                         [](const Cpu* cpu)
-                         {
-                             const uint16_t imm = cpu->opcodes->cd();
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                             cpu->flags->Add(*rd, imm);
-
-                             *rd += imm;
-                         }
+                         Add<uint16_t, ImmediateOperands>,
+                         ImmediateOperands<uint16_t>::Decode
                      ));
 
     aHaL_bH.Register(0x79, 0x2, Instruction(
                          "CMP.W #xx:16, Rd",
                          4,
                          2,
-                         [](const Cpu* cpu)
-                         {
-                             const uint16_t imm = cpu->opcodes->cd();
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                             cpu->flags->Sub(*rd, imm);
-                         }
+                         Cmp<uint16_t, ImmediateOperands>,
+                         ImmediateOperands<uint16_t>::Decode
                      ));
 
     aHaL_bH.Register(0x79, 0x3, Instruction(
                          "SUB.W #xx:16, Rd",
                          4,
                          2,
-                         [](const Cpu* cpu)
-                         {
-                             const uint16_t imm = cpu->opcodes->cd();
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                             cpu->flags->Sub(*rd, imm);
-
-                             *rd -= imm;
-                         }
+                         Sub<uint16_t, ImmediateOperands>,
+                         ImmediateOperands<uint16_t>::Decode
                      ));
 
     aHaL_bH.Register(0x79, 0x4, Instruction(
                          "OR.W #xx:16, Rd",
                          4,
                          2,
-                         [](const Cpu* cpu)
-                         {
-                             const uint16_t imm = cpu->opcodes->cd();
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                             *rd |= imm;
-            
-                             cpu->flags->Mov(*rd);
-                         }
+                         Or<uint16_t, ImmediateOperands>,
+                         ImmediateOperands<uint16_t>::Decode
                      ));
 
     aHaL_bH.Register(0x79, 0x6, Instruction(
                          "AND.W #xx:16, Rd",
                          4,
                          2,
-                         [](const Cpu* cpu)
-                         {
-                             const uint16_t imm = cpu->opcodes->cd();
-                             uint16_t* rd = cpu->registers->Register16(cpu->opcodes->bL());
-
-                             *rd &= imm;
-            
-                             cpu->flags->Mov(*rd);
-                         }
+                         And<uint16_t, ImmediateOperands>,
+                         ImmediateOperands<uint16_t>::Decode
                      ));
 
     aHaL_bH.Register(0x7A, 0x0, Instruction(
                          "MOV.L #xx:32, ERd",
                          6,
                          3,
-                         [](const Cpu* cpu)
-                         {
-                             const uint32_t imm = cpu->opcodes->cd() << 16 | cpu->opcodes->ef();
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-
-                             *erd = imm;
-           
-                             cpu->flags->Mov(*erd);
-                         }
+                         Mov<uint32_t, ImmediateOperands>,
+                         ImmediateOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register(0x7A, 0x1, Instruction(
                          "ADD.L #xx:32, ERd",
                          6,
                          3,
-                         [](const Cpu* cpu)
-                         {
-                             const uint32_t imm = cpu->opcodes->cd() << 16 | cpu->opcodes->ef();
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-           
-                             cpu->flags->Add(*erd, imm);
-
-                             *erd += imm;
-                         }
+                         Add<uint32_t, ImmediateOperands>,
+                         ImmediateOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register(0x7A, 0x2, Instruction(
                          "CMP.L #xx:32, ERd",
                          6,
                          3,
-                         [](const Cpu* cpu)
-                         {
-                             const uint32_t imm = cpu->opcodes->cd() << 16 | cpu->opcodes->ef();
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-           
-                             cpu->flags->Sub(*erd, imm);
-                         }
+                         Cmp<uint32_t, ImmediateOperands>,
+                         ImmediateOperands<uint32_t>::Decode
                      ));
 
     aHaL_bH.Register(0x7A, 0x6, Instruction(
                          "AND.L #xx:32, ERd",
                          6,
                          3,
-                         [](const Cpu* cpu)
-                         {
-                             const uint32_t imm = cpu->opcodes->cd() << 16 | cpu->opcodes->ef();
-                             uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bL());
-           
-                             *erd &= imm;
-
-                             cpu->flags->Mov(*erd);
-                         }
+                         And<uint32_t, ImmediateOperands>,
+                         ImmediateOperands<uint32_t>::Decode
                      ));
 
     aHaLbHbLcH_cL.Register(0x1C05, 0x2, Instruction(
                                "MULXS.W Rs, ERd",
                                4,
                                2 + 20,
-                               [](const Cpu* cpu)
+                               [](Cpu* cpu)
                                {
+                                   cpu->flags->Resolve();
+
                                    uint16_t* rs = cpu->registers->Register16(cpu->opcodes->dH());
                                    uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dL());
 
@@ -2102,8 +2027,10 @@ InstructionTable::InstructionTable() :
                                "DIVXS.W Rs, ERd",
                                4,
                                2 + 20,
-                               [](const Cpu* cpu)
+                               [](Cpu* cpu)
                                {
+                                   cpu->flags->Resolve();
+
                                    const uint16_t* rs = cpu->registers->Register16(cpu->opcodes->dH());
                                    uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dL());
 
@@ -2122,7 +2049,7 @@ InstructionTable::InstructionTable() :
                                "XOR.L ERs, ERd",
                                4,
                                2,
-                               [](const Cpu* cpu)
+                               [](Cpu* cpu)
                                {
                                    uint32_t* ers = cpu->registers->Register32(cpu->opcodes->dH());
                                    uint32_t* erd = cpu->registers->Register32(cpu->opcodes->dL());
@@ -2141,19 +2068,8 @@ InstructionTable::InstructionTable() :
           "BLD #xx:3, @ERd",
           4,
           2 + 2,
-          [](const Cpu* cpu)
-          {
-              if (cpu->opcodes->dH() & 0b1000)
-              {
-                  throw std::runtime_error(std::format("Unimplemented BILD instruction at 0x{:04X}", cpu->registers->pc));
-              }
-
-              const uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-              const uint8_t memoryValue = cpu->ram->ReadByte(*erd);
-              const uint8_t imm = cpu->opcodes->dH() & 0b111;
-              
-              cpu->flags->carry = (memoryValue >> imm) & 1;
-          }
+          Bld<IndirectBit>,
+          IndirectBit::Decode
       )
     );
     
@@ -2164,23 +2080,8 @@ InstructionTable::InstructionTable() :
           "BST #xx:3, @ERd",
           4,
           2 + 2,
-          [](const Cpu* cpu)
-          {
-              if (cpu->opcodes->dH() & 0b1000)
-              {
-                  throw std::runtime_error(std::format("Unimplemented BIST instruction at 0x{:04X}", cpu->registers->pc));
-              }
-
-              const uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-              const uint8_t memoryValue = cpu->ram->ReadByte(*erd);
-              const uint8_t imm = cpu->opcodes->dH() & 0b111;
-
-              if (cpu->flags->carry) {
-                  cpu->ram->WriteByte(*erd, memoryValue | 1 << imm);
-              } else {
-                  cpu->ram->WriteByte(*erd, memoryValue & ~(1 << imm));
-              }
-          }
+          Bst<IndirectBit>,
+          IndirectBit::Decode
       )
     );
 
@@ -2191,13 +2092,8 @@ InstructionTable::InstructionTable() :
            "BSET #xx:3 @ERd",
            4,
            2 + 2,
-           [](const Cpu* cpu)
-           {
-               const uint8_t imm = cpu->opcodes->dH() & 0b111;
-               const uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-               
-               cpu->ram->WriteByte(*erd, cpu->ram->ReadByte(*erd) | 1 << imm);
-           }
+           Bset<IndirectBit>,
+           IndirectBit::Decode
        )
     );
 
@@ -2208,13 +2104,8 @@ InstructionTable::InstructionTable() :
            "BNOT #xx:3 @ERd",
            4,
            2 + 2,
-           [](const Cpu* cpu)
-           {
-               const uint8_t imm = cpu->opcodes->dH() & 0b111;
-               const uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-               
-               cpu->ram->WriteByte(*erd, cpu->ram->ReadByte(*erd) ^ (1 << imm));
-           }
+           Bnot<IndirectBit>,
+           IndirectBit::Decode
        )
     );
     
@@ -2225,13 +2116,8 @@ InstructionTable::InstructionTable() :
           "BCLR #xx:3, @ERd",
           4,
           2 + 2,
-          [](const Cpu* cpu)
-          {
-              const uint8_t imm = cpu->opcodes->dH() & 0b111;
-              const uint32_t* erd = cpu->registers->Register32(cpu->opcodes->bH());
-                
-              cpu->ram->WriteByte(*erd, cpu->ram->ReadByte(*erd) & ~(1 << imm));
-          }
+          Bclr<IndirectBit>,
+          IndirectBit::Decode
       )
     );
 
@@ -2242,20 +2128,8 @@ InstructionTable::InstructionTable() :
            "BLD #xx:3 @aa:8",
            4,
            2 + 1,
-           [](const Cpu* cpu)
-           {
-               if (cpu->opcodes->dH() & 0b1000)
-               {
-                   throw std::runtime_error(std::format("Unimplemented BILD instruction at 0x{:04X}", cpu->registers->pc));
-               }
-               
-               const uint8_t imm = cpu->opcodes->dH() & 0b111;
-               const uint16_t address = cpu->opcodes->b() | 0xFF00;
-
-               const uint8_t memoryValue = cpu->ram->ReadByte(address);
-               
-               cpu->flags->carry = (memoryValue >> imm) & 1;
-           }
+           Bld<AbsoluteBit>,
+           AbsoluteBit::Decode
        )
     );
     
@@ -2266,13 +2140,8 @@ InstructionTable::InstructionTable() :
             "BSET #xx:3, @aa:8",
             4,
             2 + 2,
-            [](const Cpu* cpu)
-            {
-                const uint8_t imm = cpu->opcodes->dH() & 0b111;
-                const uint16_t address = cpu->opcodes->b() | 0xFF00;
-                
-                cpu->ram->WriteByte(address, cpu->ram->ReadByte(address) | 1 << imm);
-            }
+            Bset<AbsoluteBit>,
+            AbsoluteBit::Decode
         )
     );
 
@@ -2283,18 +2152,86 @@ InstructionTable::InstructionTable() :
            "BCLR #xx:3 @aa:8",
            4,
            2 + 2,
-           [](const Cpu* cpu)
-           {
-               const uint8_t imm = cpu->opcodes->dH() & 0b111;
-               const uint16_t address = cpu->opcodes->b() | 0xFF00;
-
-               cpu->ram->WriteByte(address, cpu->ram->ReadByte(address) & ~(1 << imm));
-           }
+           Bclr<AbsoluteBit>,
+           AbsoluteBit::Decode
        )
     );
+
+    BuildDecodeTable();
+}
+
+InstructionTable* InstructionTable::Shared()
+{
+    static InstructionTable table;
+    return &table;
 }
 
 Instruction* InstructionTable::Execute(Cpu* cpu)
 {
-    return aH_aL.Execute(cpu);
+    Instruction* instruction = Decode(cpu->opcodes);
+    if (instruction == nullptr)
+    {
+        // let the containers report which table is missing the instruction
+        return aH_aL.Execute(cpu);
+    }
+
+    instruction->Resolve(cpu->opcodes, cpu->registers, cpu->decodedOperands);
+    instruction->Run(cpu, cpu->decodedOperands);
+    
+    return instruction;
+}
+
+Instruction* InstructionTable::Decode(Opcode* opcode)
+{
+    DecodeEntry& entry = (*decodeTable)[opcode->ab()];
+    if (!entry.isSecondWord)
+    {
+        return entry.instruction;
+    }
+
+    SecondWordTable* secondWord = entry.secondWord.load(std::memory_order_acquire);
+    if (secondWord == nullptr)
+    {
+        auto created = std::make_unique<SecondWordTable>();
+        if (entry.secondWord.compare_exchange_strong(secondWord, created.get(), std::memory_order_acq_rel))
+        {
+            secondWord = created.release();
+        }
+    }
+
+    std::atomic<Instruction*>& slot = (*secondWord)[opcode->cd() >> 4];
+    Instruction* instruction = slot.load(std::memory_order_relaxed);
+    if (instruction == nullptr)
+    {
+        instruction = aH_aL.Decode(opcode);
+        slot.store(instruction, std::memory_order_relaxed);
+    }
+
+    return instruction;
+}
+
+void InstructionTable::BuildDecodeTable()
+{
+    decodeTable = std::make_unique<std::array<DecodeEntry, 0x10000>>();
+
+    uint8_t scratchBuffer[8] = {};
+    Memory scratchMemory(scratchBuffer);
+    Opcode scratchOpcode(&scratchMemory);
+    
+    for (uint32_t firstWord = 0; firstWord <= 0xFFFF; firstWord++)
+    {
+        scratchBuffer[0] = firstWord >> 8;
+        scratchBuffer[1] = firstWord & 0xFF;
+        scratchOpcode.Update(0);
+
+        DecodeEntry& entry = (*decodeTable)[firstWord];
+        entry.instruction = aH_aL.Decode(&scratchOpcode);
+
+        // anything that looked past the first word gets resolved per second word on first use
+        if (scratchOpcode.IsFetched(2) || scratchOpcode.IsFetched(3))
+        {
+            entry.instruction = nullptr;
+            entry.isSecondWord = true;
+        }
+    }
 }
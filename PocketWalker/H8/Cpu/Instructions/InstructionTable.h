@@ -1,4 +1,8 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <memory>
+
 #include "InstructionContainer.h"
 
 class InstructionTable
@@ -6,10 +10,31 @@ class InstructionTable
 public:
     InstructionTable();
 
+    // nothing in the table belongs to one cpu, so every cpu in the process decodes through the same one
+    static InstructionTable* Shared();
+
     Instruction* Execute(Cpu* cpu);
+    Instruction* Decode(Opcode* opcode);
 
 private:
+    // containers never look past dH, so the second word only needs its top 12 bits,
+    // filled on first use by whichever thread gets there and always to the same value
+    using SecondWordTable = std::array<std::atomic<Instruction*>, 0x1000>;
+
+    struct DecodeEntry
+    {
+        Instruction* instruction = nullptr;
+        bool isSecondWord = false;
+        std::atomic<SecondWordTable*> secondWord;
+
+        ~DecodeEntry() { delete secondWord.load(); }
+    };
+
+    void BuildDecodeTable();
+    
     InstructionContainer aH_aL;
     InstructionContainer aHaL_bH;
     InstructionContainer aHaLbHbLcH_cL;
+
+    std::unique_ptr<std::array<DecodeEntry, 0x10000>> decodeTable;
 };
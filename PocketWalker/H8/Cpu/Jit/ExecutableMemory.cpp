@@ -0,0 +1,103 @@
+#include "ExecutableMemory.h"
+
+#include "JitConfig.h"
+
+#if POCKETWALKER_JIT
+#if _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#endif
+
+ExecutableMemory::ExecutableMemory(const size_t size) : size(size)
+{
+#if POCKETWALKER_JIT
+#if _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    pageSize = info.dwPageSize;
+    
+    buffer = static_cast<uint8_t*>(VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+#else
+    pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    buffer = mapping == MAP_FAILED ? nullptr : static_cast<uint8_t*>(mapping);
+#endif
+#endif
+}
+
+ExecutableMemory::~ExecutableMemory()
+{
+#if POCKETWALKER_JIT
+    if (buffer == nullptr)
+        return;
+    
+#if _WIN32
+    VirtualFree(buffer, 0, MEM_RELEASE);
+#else
+    munmap(buffer, size);
+#endif
+#endif
+}
+
+uint8_t* ExecutableMemory::Allocate(const size_t allocationSize)
+{
+    if (buffer == nullptr || used + allocationSize > size)
+        return nullptr;
+
+    uint8_t* allocation = buffer + used;
+    used += (allocationSize + 15) & ~static_cast<size_t>(15);
+    
+    return allocation;
+}
+
+void ExecutableMemory::Reset()
+{
+    used = 0;
+}
+
+void ExecutableMemory::BeginWrite([[maybe_unused]] uint8_t* start, [[maybe_unused]] const size_t length)
+{
+#if POCKETWALKER_JIT
+    uint8_t* first;
+    size_t pagesLength;
+    GetPages(start, length, first, pagesLength);
+    
+#if _WIN32
+    DWORD oldProtect;
+    VirtualProtect(first, pagesLength, PAGE_READWRITE, &oldProtect);
+#else
+    mprotect(first, pagesLength, PROT_READ | PROT_WRITE);
+#endif
+#endif
+}
+
+void ExecutableMemory::EndWrite([[maybe_unused]] uint8_t* start, [[maybe_unused]] const size_t length)
+{
+#if POCKETWALKER_JIT
+    uint8_t* first;
+    size_t pagesLength;
+    GetPages(start, length, first, pagesLength);
+    
+#if _WIN32
+    DWORD oldProtect;
+    VirtualProtect(first, pagesLength, PAGE_EXECUTE_READ, &oldProtect);
+    FlushInstructionCache(GetCurrentProcess(), start, length);
+#else
+    mprotect(first, pagesLength, PROT_READ | PROT_EXEC);
+#endif
+#endif
+}
+
+void ExecutableMemory::GetPages(uint8_t* start, const size_t length, uint8_t*& first, size_t& pagesLength) const
+{
+    const size_t offset = start - buffer;
+    const size_t firstOffset = offset / pageSize * pageSize;
+    const size_t endOffset = (offset + length + pageSize - 1) / pageSize * pageSize;
+    
+    first = buffer + firstOffset;
+    pagesLength = endOffset - firstOffset;
+}
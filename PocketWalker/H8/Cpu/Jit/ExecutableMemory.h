@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// a single region that is only ever writable or executable, never both
+class ExecutableMemory
+{
+public:
+    ExecutableMemory(size_t size);
+    ~ExecutableMemory();
+
+    uint8_t* Allocate(size_t size);
+    void Reset();
+    
+    // flip only the pages the range sits on, the rest of the region keeps running
+    void BeginWrite(uint8_t* start, size_t length);
+    void EndWrite(uint8_t* start, size_t length);
+
+    bool IsValid() const { return buffer != nullptr; }
+    
+private:
+    void GetPages(uint8_t* start, size_t length, uint8_t*& first, size_t& pagesLength) const;
+
+    uint8_t* buffer = nullptr;
+    size_t size = 0;
+    size_t used = 0;
+    size_t pageSize = 0x1000;
+};
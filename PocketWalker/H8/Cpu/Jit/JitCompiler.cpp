@@ -0,0 +1,622 @@
+#include "JitCompiler.h"
+
+#include <cstring>
+#include <vector>
+
+#include "JitConfig.h"
+#include "../Cpu.h"
+
+namespace
+{
+    // first two integer arguments
+#if _WIN32
+    constexpr auto FIRST_ARGUMENT = X64Emitter::RCX;
+    constexpr auto SECOND_ARGUMENT = X64Emitter::RDX;
+#else
+    constexpr auto FIRST_ARGUMENT = X64Emitter::RDI;
+    constexpr auto SECOND_ARGUMENT = X64Emitter::RSI;
+#endif
+
+    template<typename T>
+    uint64_t Address(T* pointer)
+    {
+        return reinterpret_cast<uint64_t>(pointer);
+    }
+
+    // ccr bits from the Flags layout, so the masks below don't hardcode it
+    uint8_t FlagMask(const bool carry, const bool overflow, const bool zero, const bool negative, const bool halfCarry)
+    {
+        Flags flags;
+        flags.carry = carry;
+        flags.overflow = overflow;
+        flags.zero = zero;
+        flags.negative = negative;
+        flags.halfCarry = halfCarry;
+        return flags.ccr;
+    }
+
+    // register and immediate alu forms, their operands come resolved from the instruction cache
+    struct AluForm
+    {
+        X64Emitter::Operation operation;
+        size_t size;
+        bool isImmediate;
+    };
+
+    bool GetAluForm(const uint8_t* opcode, AluForm& form)
+    {
+        const uint8_t high = opcode[1] >> 4;
+        switch (opcode[0])
+        {
+        case 0x08: form = {X64Emitter::ADD, 1, false}; return true;
+        case 0x09: form = {X64Emitter::ADD, 2, false}; return true;
+        case 0x0C: form = {X64Emitter::MOV, 1, false}; return true;
+        case 0x0D: form = {X64Emitter::MOV, 2, false}; return true;
+        case 0x14: form = {X64Emitter::OR, 1, false}; return true;
+        case 0x15: form = {X64Emitter::XOR, 1, false}; return true;
+        case 0x16: form = {X64Emitter::AND, 1, false}; return true;
+        case 0x18: form = {X64Emitter::SUB, 1, false}; return true;
+        case 0x19: form = {X64Emitter::SUB, 2, false}; return true;
+        case 0x1C: form = {X64Emitter::CMP, 1, false}; return true;
+        case 0x1D: form = {X64Emitter::CMP, 2, false}; return true;
+        case 0x64: form = {X64Emitter::OR, 2, false}; return true;
+        case 0x65: form = {X64Emitter::XOR, 2, false}; return true;
+        case 0x66: form = {X64Emitter::AND, 2, false}; return true;
+
+        // the long forms share their first byte with INC, ADDS, DAA and friends, which keep bit 7 clear
+        case 0x0A: form = {X64Emitter::ADD, 4, false}; return high >= 0x8;
+        case 0x0F: form = {X64Emitter::MOV, 4, false}; return high >= 0x8;
+        case 0x1A: form = {X64Emitter::SUB, 4, false}; return high >= 0x8;
+        case 0x1F: form = {X64Emitter::CMP, 4, false}; return high >= 0x8;
+
+        case 0x79:
+        case 0x7A:
+            {
+                const size_t size = opcode[0] == 0x79 ? 2 : 4;
+                switch (high)
+                {
+                case 0x0: form = {X64Emitter::MOV, size, true}; return true;
+                case 0x1: form = {X64Emitter::ADD, size, true}; return true;
+                case 0x2: form = {X64Emitter::CMP, size, true}; return true;
+                case 0x3: form = {X64Emitter::SUB, size, true}; return size == 2;
+                case 0x4: form = {X64Emitter::OR, size, true}; return size == 2;
+                case 0x6: form = {X64Emitter::AND, size, true}; return true;
+                default: return false;
+                }
+            }
+        default:
+            break;
+        }
+
+        switch (opcode[0] >> 4)
+        {
+        case 0x8: form = {X64Emitter::ADD, 1, true}; return true;
+        case 0xA: form = {X64Emitter::CMP, 1, true}; return true;
+        case 0xC: form = {X64Emitter::OR, 1, true}; return true;
+        case 0xD: form = {X64Emitter::XOR, 1, true}; return true;
+        case 0xE: form = {X64Emitter::AND, 1, true}; return true;
+        case 0xF: form = {X64Emitter::MOV, 1, true}; return true;
+        default: return false;
+        }
+    }
+
+    // MOV between a register and @ERn, @(d:16, ERn) or @aa:16
+    struct MemoryForm
+    {
+        size_t size;
+        bool isStore;
+        bool isAbsolute;
+        uint8_t pointer;
+        uint8_t data;
+        int16_t displacement;
+        uint16_t address;
+    };
+
+    bool GetMemoryForm(const uint8_t* opcode, MemoryForm& form)
+    {
+        form = {};
+
+        // the byte with the direction bit, the pointer register and the data register
+        uint8_t registers;
+        switch (opcode[0])
+        {
+        case 0x68:
+        case 0x69:
+            form.size = opcode[0] == 0x68 ? 1 : 2;
+            registers = opcode[1];
+            break;
+        case 0x6E:
+        case 0x6F:
+            form.size = opcode[0] == 0x6E ? 1 : 2;
+            registers = opcode[1];
+            form.displacement = static_cast<int16_t>(opcode[2] << 8 | opcode[3]);
+            break;
+        case 0x6A:
+        case 0x6B:
+            // aa:24 uses the same first byte with bit 1 of the high nibble set
+            if ((opcode[1] >> 4 & 0x7) != 0)
+                return false;
+
+            form.size = opcode[0] == 0x6A ? 1 : 2;
+            form.isAbsolute = true;
+            form.address = static_cast<uint16_t>(opcode[2] << 8 | opcode[3]);
+            registers = opcode[1];
+            break;
+        case 0x01:
+            if (opcode[1] != 0x00 || (opcode[2] != 0x69 && opcode[2] != 0x6F))
+                return false;
+
+            form.size = 4;
+            registers = opcode[3];
+            if (opcode[2] == 0x6F)
+            {
+                form.displacement = static_cast<int16_t>(opcode[4] << 8 | opcode[5]);
+            }
+            break;
+        default:
+            return false;
+        }
+
+        form.isStore = registers >> 7;
+        form.pointer = registers >> 4 & 0x7;
+        form.data = registers & 0xF;
+        return true;
+    }
+}
+
+JitCompiler::JitCompiler(Cpu* cpu) : cpu(cpu), memory(POCKETWALKER_JIT ? CODE_SIZE : 0)
+{
+
+}
+
+NativeBlock JitCompiler::Compile(const Block& block)
+{
+#if POCKETWALKER_JIT
+    X64Emitter emitter;
+
+    // push rbx, sub rsp 32 keeps the stack aligned and leaves shadow space for win64
+    emitter.Byte(0x53);
+    emitter.Bytes({0x48, 0x83, 0xEC, 0x20});
+
+    std::vector<PendingExit> exits;
+
+    size_t cycles = 0;
+    size_t instructionCount = 0;
+    for (const BlockOp& op : block.ops)
+    {
+        cycles += op.cycles;
+        instructionCount += op.instructionCount;
+
+        PendingExit exit = { {}, cycles, instructionCount };
+        if (!EmitNative(emitter, op, block.generation, exit))
+        {
+            EmitCall(emitter, op);
+            EmitCallChecks(emitter, op, block.generation, exit);
+        }
+
+        if (!exit.jumps.empty())
+        {
+            exits.push_back(exit);
+        }
+    }
+
+    EmitExit(emitter, cycles, instructionCount);
+
+    for (const PendingExit& exit : exits)
+    {
+        const size_t target = emitter.Position();
+        for (const size_t jump : exit.jumps)
+        {
+            emitter.Patch(jump, target);
+        }
+
+        EmitExit(emitter, exit.cycles, exit.instructionCount);
+    }
+
+    uint8_t* code = memory.Allocate(emitter.code.size());
+    if (code == nullptr)
+        return nullptr;
+
+    memory.BeginWrite(code, emitter.code.size());
+    std::memcpy(code, emitter.code.data(), emitter.code.size());
+    memory.EndWrite(code, emitter.code.size());
+
+    return reinterpret_cast<NativeBlock>(code);
+#else
+    return nullptr;
+#endif
+}
+
+void JitCompiler::Reset()
+{
+    memory.Reset();
+}
+
+bool JitCompiler::IsAvailable() const
+{
+    return POCKETWALKER_JIT && memory.IsValid();
+}
+
+bool JitCompiler::EmitNative(X64Emitter& emitter, const BlockOp& op, const uint32_t generation, PendingExit& exit) const
+{
+    if (op.instructionCount != 1)
+        return false;
+
+    const uint8_t* opcode = op.opcode;
+    if (opcode[0] == 0x00 && opcode[1] == 0x00)
+    {
+        // NOP
+    }
+    else if (cpu->flags->lazy)
+    {
+        // flags written straight into ccr would be overwritten by a deferred update
+        return false;
+    }
+    else if (opcode[0] >> 4 == 0xF)
+    {
+        // MOV.B #xx:8, Rd
+        const uint8_t value = opcode[1];
+
+        emitter.MovImmediate(X64Emitter::RCX, Address(cpu->registers->Register8(opcode[0] & 0xF)));
+        emitter.StoreByte(value);
+        EmitFlags(emitter, value & 0x80, value == 0);
+    }
+    else if (opcode[0] == 0x79 && opcode[1] >> 4 == 0x0)
+    {
+        // MOV.W #xx:16, Rd
+        const uint16_t value = opcode[2] << 8 | opcode[3];
+
+        emitter.MovImmediate(X64Emitter::RCX, Address(cpu->registers->Register16(opcode[1] & 0xF)));
+        emitter.StoreWord(value);
+        EmitFlags(emitter, value & 0x8000, value == 0);
+    }
+    else if (opcode[0] == 0x7A && opcode[1] >> 4 == 0x0)
+    {
+        // MOV.L #xx:32, ERd
+        const uint32_t value = opcode[2] << 24 | opcode[3] << 16 | opcode[4] << 8 | opcode[5];
+
+        emitter.MovImmediate(X64Emitter::RCX, Address(cpu->registers->Register32(opcode[1] & 0xF)));
+        emitter.StoreDword(value);
+        EmitFlags(emitter, value & 0x80000000, value == 0);
+    }
+    else if (EmitBranch(emitter, op, exit))
+    {
+        // sets pc itself
+        return true;
+    }
+    else if (!EmitAlu(emitter, op) && !EmitMemory(emitter, op, generation, exit))
+    {
+        return false;
+    }
+
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->registers->pc));
+    emitter.StoreWord(op.nextAddress);
+
+    return true;
+}
+
+bool JitCompiler::EmitAlu(X64Emitter& emitter, const BlockOp& op) const
+{
+    AluForm form;
+    if (!GetAluForm(op.opcode, form) || op.instruction->decode == nullptr)
+        return false;
+
+    const size_t size = form.size;
+    const InstructionOperands& operands = op.operands;
+
+    // edx is the source, eax the destination before and ebx after
+    if (form.isImmediate)
+    {
+        emitter.MovImmediate32(X64Emitter::RDX, operands.immediate);
+    }
+    else
+    {
+        emitter.MovImmediate(X64Emitter::RDX, Address(operands.source));
+        emitter.Load(X64Emitter::RDX, X64Emitter::RDX, size);
+    }
+
+    emitter.MovImmediate(X64Emitter::RCX, Address(operands.destination));
+    emitter.Load(X64Emitter::RAX, X64Emitter::RCX, size);
+    emitter.MovRegister(X64Emitter::RBX, X64Emitter::RAX);
+
+    switch (form.operation)
+    {
+    case X64Emitter::MOV:
+        emitter.MovRegister(X64Emitter::RBX, X64Emitter::RDX);
+        emitter.Alu(X64Emitter::TEST, X64Emitter::RBX, X64Emitter::RBX, size);
+        EmitLogicFlags(emitter);
+        break;
+    case X64Emitter::AND:
+    case X64Emitter::OR:
+    case X64Emitter::XOR:
+        emitter.Alu(form.operation, X64Emitter::RBX, X64Emitter::RDX, size);
+        EmitLogicFlags(emitter);
+        break;
+    default:
+        // CMP still needs the difference for the flags, it just doesn't store it
+        emitter.Alu(form.operation == X64Emitter::ADD ? X64Emitter::ADD : X64Emitter::SUB, X64Emitter::RBX, X64Emitter::RDX, size);
+        EmitArithmeticFlags(emitter, size, form.operation == X64Emitter::ADD);
+        break;
+    }
+
+    if (form.operation != X64Emitter::CMP)
+    {
+        emitter.MovImmediate(X64Emitter::RCX, Address(operands.destination));
+        emitter.Store(X64Emitter::RCX, X64Emitter::RBX, size);
+    }
+
+    return true;
+}
+
+bool JitCompiler::EmitMemory(X64Emitter& emitter, const BlockOp& op, const uint32_t generation, PendingExit& exit) const
+{
+    MemoryForm form;
+    if (!GetMemoryForm(op.opcode, form))
+        return false;
+
+    const size_t size = form.size;
+    void* data;
+    switch (size)
+    {
+    case 1:
+        data = cpu->registers->Register8(form.data);
+        break;
+    case 2:
+        data = cpu->registers->Register16(form.data);
+        break;
+    default:
+        data = cpu->registers->Register32(form.data);
+        break;
+    }
+
+    // the 16 bit address in eax
+    if (form.isAbsolute)
+    {
+        emitter.MovImmediate32(X64Emitter::RAX, form.address);
+    }
+    else
+    {
+        emitter.MovImmediate(X64Emitter::RCX, Address(cpu->registers->Register32(form.pointer)));
+        emitter.Load(X64Emitter::RAX, X64Emitter::RCX, 4);
+        if (form.displacement != 0)
+        {
+            emitter.AddImmediate(X64Emitter::RAX, static_cast<uint32_t>(form.displacement));
+        }
+
+        emitter.ZeroExtendWord(X64Emitter::RAX);
+    }
+
+    // pages with handlers, watches or read only registers go through the interpreter, the flags are checked
+    // when the block runs since they change after it's compiled
+    std::vector<size_t> slowJumps;
+    emitter.MovImmediate(X64Emitter::RCX, Address(cpu->ram->GetPageFlags()));
+    emitter.MovRegister(X64Emitter::RDX, X64Emitter::RAX);
+    emitter.ShiftRight(X64Emitter::RDX, MEMORY_PAGE_SHIFT);
+    emitter.CompareIndexedByte(X64Emitter::RCX, X64Emitter::RDX, 0);
+    slowJumps.push_back(emitter.JumpIf(X64Emitter::NOT_ZERO));
+
+    if (size > 1)
+    {
+        // the last byte can be on the next page, or past the end of memory
+        emitter.MovRegister(X64Emitter::RDX, X64Emitter::RAX);
+        emitter.AddImmediate(X64Emitter::RDX, static_cast<uint32_t>(size - 1));
+        emitter.CompareImmediate(X64Emitter::RDX, 0xFFFF);
+        slowJumps.push_back(emitter.JumpIf(X64Emitter::ABOVE));
+        emitter.ShiftRight(X64Emitter::RDX, MEMORY_PAGE_SHIFT);
+        emitter.CompareIndexedByte(X64Emitter::RCX, X64Emitter::RDX, 0);
+        slowJumps.push_back(emitter.JumpIf(X64Emitter::NOT_ZERO));
+    }
+
+    emitter.MovImmediate(X64Emitter::RCX, Address(cpu->ram->buffer));
+    if (form.isStore)
+    {
+        emitter.MovImmediate(X64Emitter::RDX, Address(data));
+        emitter.Load(X64Emitter::RDX, X64Emitter::RDX, size);
+        emitter.MovRegister(X64Emitter::RBX, X64Emitter::RDX);
+        emitter.SwapBytes(X64Emitter::RBX, size);
+        emitter.StoreIndexed(X64Emitter::RCX, X64Emitter::RAX, X64Emitter::RBX, size);
+    }
+    else
+    {
+        emitter.LoadIndexed(X64Emitter::RDX, X64Emitter::RCX, X64Emitter::RAX, size);
+        emitter.SwapBytes(X64Emitter::RDX, size);
+        emitter.MovImmediate(X64Emitter::RCX, Address(data));
+        emitter.Store(X64Emitter::RCX, X64Emitter::RDX, size);
+    }
+
+    emitter.Alu(X64Emitter::TEST, X64Emitter::RDX, X64Emitter::RDX, size);
+    EmitLogicFlags(emitter);
+    const size_t done = emitter.Jump();
+
+    const size_t slow = emitter.Position();
+    for (const size_t jump : slowJumps)
+    {
+        emitter.Patch(jump, slow);
+    }
+
+    EmitCall(emitter, op);
+    EmitCallChecks(emitter, op, generation, exit);
+
+    emitter.Patch(done, emitter.Position());
+    return true;
+}
+
+bool JitCompiler::EmitBranch(X64Emitter& emitter, const BlockOp& op, PendingExit& exit) const
+{
+    // Bcc d:8 is 4x, Bcc d:16 is 58 x0, with the condition in x
+    uint8_t condition;
+    if (op.opcode[0] >> 4 == 0x4)
+        condition = op.opcode[0] & 0xF;
+    else if (op.opcode[0] == 0x58 && (op.opcode[1] & 0xF) == 0)
+        condition = op.opcode[1] >> 4;
+    else
+        return false;
+
+    if (op.instruction->decode == nullptr)
+        return false;
+
+    const uint16_t target = static_cast<uint16_t>(op.nextAddress + op.operands.displacement);
+
+    // BRA and BRN
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->registers->pc));
+    if (condition <= 0x1)
+    {
+        emitter.StoreWord(condition == 0x0 ? target : op.nextAddress);
+        if (condition == 0x0)
+        {
+            exit.jumps.push_back(emitter.Jump());
+        }
+
+        return true;
+    }
+
+    emitter.StoreWord(op.nextAddress);
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->flags->ccr));
+
+    // pairs of conditions test the same bits, the odd one branches when they're set
+    const uint8_t test = condition >> 1;
+    if (test <= 0x5)
+    {
+        const uint8_t masks[] = {
+            0,
+            FlagMask(true, false, true, false, false),
+            FlagMask(true, false, false, false, false),
+            FlagMask(false, false, true, false, false),
+            FlagMask(false, true, false, false, false),
+            FlagMask(false, false, false, true, false)
+        };
+        emitter.TestByte(masks[test]);
+    }
+    else
+    {
+        // N xor V, shifted down onto V, and for BGT/BLE or'd with Z
+        emitter.Load(X64Emitter::RAX, X64Emitter::RCX, 1);
+        emitter.MovRegister(X64Emitter::RDX, X64Emitter::RAX);
+        emitter.ShiftRight(X64Emitter::RDX, 2);
+        emitter.Alu(X64Emitter::XOR, X64Emitter::RDX, X64Emitter::RAX, 4);
+        emitter.AndImmediate(X64Emitter::RDX, FlagMask(false, true, false, false, false));
+        if (test == 0x7)
+        {
+            emitter.AndImmediate(X64Emitter::RAX, FlagMask(false, false, true, false, false));
+            emitter.Alu(X64Emitter::OR, X64Emitter::RDX, X64Emitter::RAX, 4);
+        }
+    }
+
+    const size_t notTaken = emitter.JumpIf(condition & 1 ? X64Emitter::ZERO : X64Emitter::NOT_ZERO);
+
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->registers->pc));
+    emitter.StoreWord(target);
+    exit.jumps.push_back(emitter.Jump());
+
+    emitter.Patch(notTaken, emitter.Position());
+    return true;
+}
+
+void JitCompiler::EmitCall(X64Emitter& emitter, const BlockOp& op) const
+{
+    emitter.MovImmediate(FIRST_ARGUMENT, Address(cpu));
+    emitter.MovImmediate(SECOND_ARGUMENT, Address(&op));
+    emitter.MovImmediate(X64Emitter::RAX, reinterpret_cast<uint64_t>(op.handler));
+    emitter.CallRax();
+}
+
+void JitCompiler::EmitCallChecks(X64Emitter& emitter, const BlockOp& op, const uint32_t generation, PendingExit& exit) const
+{
+    // taken branches, sleeps and code writes all leave the block early
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->registers->pc));
+    emitter.CompareWord(op.nextAddress);
+    exit.jumps.push_back(emitter.JumpNotEqual());
+
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->sleeping));
+    emitter.CompareByte(0);
+    exit.jumps.push_back(emitter.JumpNotEqual());
+
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->instructionCache->generation));
+    emitter.CompareDword(generation);
+    exit.jumps.push_back(emitter.JumpNotEqual());
+}
+
+void JitCompiler::EmitFlags(X64Emitter& emitter, const bool negative, const bool zero) const
+{
+    // same as Flags::Mov, clear N/Z/V then set what the constant result implies
+    const uint8_t clearMask = ~FlagMask(false, true, true, true, false);
+    const uint8_t setMask = FlagMask(false, false, zero, negative, false);
+
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->flags->ccr));
+    emitter.AndByte(clearMask);
+    if (setMask != 0)
+    {
+        emitter.OrByte(setMask);
+    }
+}
+
+void JitCompiler::EmitLogicFlags(X64Emitter& emitter) const
+{
+    // same as Flags::Mov from the host flags of a logic op or test, which clear overflow like it does,
+    // x86 zero and sign sit four bits above h8's
+    emitter.PushFlags();
+    emitter.Pop(X64Emitter::RAX);
+    emitter.ShiftRight(X64Emitter::RAX, 4);
+    emitter.AndImmediate(X64Emitter::RAX, FlagMask(false, false, true, true, false));
+
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->flags->ccr));
+    emitter.AndByte(~FlagMask(false, true, true, true, false));
+    emitter.OrByteRegister(X64Emitter::RAX);
+}
+
+void JitCompiler::EmitArithmeticFlags(X64Emitter& emitter, const size_t size, const bool isAdd) const
+{
+    // same as Flags::Add and Flags::Sub with eax the destination, edx the source and ebx the result,
+    // overflow and half carry use the same formulas as those rather than the host's
+    const uint8_t bits = static_cast<uint8_t>(size * 8);
+    emitter.PushFlags();
+
+    // V is bit 1, from the top bit of (rd ^ rs) & (rd ^ result)
+    emitter.MovRegister(X64Emitter::RCX, X64Emitter::RAX);
+    emitter.Alu(X64Emitter::XOR, X64Emitter::RCX, X64Emitter::RBX, 4);
+    emitter.Alu(X64Emitter::XOR, X64Emitter::RAX, X64Emitter::RDX, 4);
+    emitter.MovRegister(X64Emitter::RDX, X64Emitter::RAX);
+    emitter.Alu(X64Emitter::AND, X64Emitter::RDX, X64Emitter::RCX, 4);
+    emitter.ShiftRight(X64Emitter::RDX, bits - 2);
+    emitter.AndImmediate(X64Emitter::RDX, FlagMask(false, true, false, false, false));
+
+    // H is bit 5, from the middle bit of rd ^ rs ^ result
+    emitter.Alu(X64Emitter::XOR, X64Emitter::RAX, X64Emitter::RBX, 4);
+    emitter.ShiftRight(X64Emitter::RAX, bits / 2 - 1);
+    emitter.AndImmediate(X64Emitter::RAX, 1);
+    emitter.ShiftLeft(X64Emitter::RAX, 5);
+    emitter.Alu(X64Emitter::OR, X64Emitter::RAX, X64Emitter::RDX, 4);
+
+    // C lines up with the host carry, Z and N sit four bits below the host's
+    emitter.Pop(X64Emitter::RCX);
+    emitter.MovRegister(X64Emitter::RDX, X64Emitter::RCX);
+    emitter.AndImmediate(X64Emitter::RDX, FlagMask(true, false, false, false, false));
+    emitter.Alu(X64Emitter::OR, X64Emitter::RAX, X64Emitter::RDX, 4);
+    emitter.ShiftRight(X64Emitter::RCX, 4);
+    emitter.AndImmediate(X64Emitter::RCX, FlagMask(false, false, true, true, false));
+    if (isAdd && size < 4)
+    {
+        // Flags::Add checks zero before the carry out is dropped, so a byte or word add that wraps to 0 isn't zero
+        emitter.ShiftLeft(X64Emitter::RDX, 2);
+        emitter.Alu(X64Emitter::AND, X64Emitter::RDX, X64Emitter::RCX, 4);
+        emitter.Alu(X64Emitter::XOR, X64Emitter::RCX, X64Emitter::RDX, 4);
+    }
+
+    emitter.Alu(X64Emitter::OR, X64Emitter::RAX, X64Emitter::RCX, 4);
+
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->flags->ccr));
+    emitter.AndByte(~FlagMask(true, true, true, true, true));
+    emitter.OrByteRegister(X64Emitter::RAX);
+}
+
+void JitCompiler::EmitExit(X64Emitter& emitter, const size_t cycles, const size_t instructionCount) const
+{
+    emitter.MovImmediate(X64Emitter::RCX, Address(&cpu->instructionCount));
+    emitter.AddQword(static_cast<uint32_t>(instructionCount));
+    emitter.MovEaxImmediate(static_cast<uint32_t>(cycles));
+
+    // add rsp 32, pop rbx, ret
+    emitter.Bytes({0x48, 0x83, 0xC4, 0x20});
+    emitter.Byte(0x5B);
+    emitter.Byte(0xC3);
+}
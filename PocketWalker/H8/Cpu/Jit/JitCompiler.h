@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ExecutableMemory.h"
+#include "X64Emitter.h"
+
+class Cpu;
+struct Block;
+struct BlockOp;
+struct InstructionOperands;
+
+using NativeBlock = size_t(*)();
+
+// translates hot blocks into x86-64, anything without a native form calls its interpreter handler
+class JitCompiler
+{
+public:
+    JitCompiler(Cpu* cpu);
+
+    NativeBlock Compile(const Block& block);
+    void Reset();
+    bool IsAvailable() const;
+    
+    static constexpr uint32_t THRESHOLD = 64;
+    static constexpr size_t CODE_SIZE = 4 * 1024 * 1024;
+
+private:
+    // jumps that leave the block with what had run up to them
+    struct PendingExit
+    {
+        std::vector<size_t> jumps;
+        size_t cycles;
+        size_t instructionCount;
+    };
+
+    bool EmitNative(X64Emitter& emitter, const BlockOp& op, uint32_t generation, PendingExit& exit) const;
+    bool EmitAlu(X64Emitter& emitter, const BlockOp& op) const;
+    bool EmitMemory(X64Emitter& emitter, const BlockOp& op, uint32_t generation, PendingExit& exit) const;
+    bool EmitBranch(X64Emitter& emitter, const BlockOp& op, PendingExit& exit) const;
+    void EmitCall(X64Emitter& emitter, const BlockOp& op) const;
+    void EmitCallChecks(X64Emitter& emitter, const BlockOp& op, uint32_t generation, PendingExit& exit) const;
+    void EmitFlags(X64Emitter& emitter, bool negative, bool zero) const;
+    void EmitLogicFlags(X64Emitter& emitter) const;
+    void EmitArithmeticFlags(X64Emitter& emitter, size_t size, bool isAdd) const;
+    void EmitExit(X64Emitter& emitter, size_t cycles, size_t instructionCount) const;
+    
+    Cpu* cpu;
+    ExecutableMemory memory;
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+// the jit tier is x86-64 only, define POCKETWALKER_NO_JIT to build without it
+#if !defined(POCKETWALKER_NO_JIT) && (defined(__x86_64__) || defined(_M_X64))
+#define POCKETWALKER_JIT 1
+#else
+#define POCKETWALKER_JIT 0
+#endif
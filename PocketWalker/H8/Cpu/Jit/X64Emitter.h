@@ -0,0 +1,200 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// just enough x86-64 encoding for the block compiler
+class X64Emitter
+{
+public:
+    enum Register : uint8_t
+    {
+        RAX = 0,
+        RCX = 1,
+        RDX = 2,
+        RBX = 3,
+        RSI = 6,
+        RDI = 7
+    };
+
+    // the byte form of each two-operand op, the word and dword forms are one above
+    enum Operation : uint8_t
+    {
+        ADD = 0x00,
+        OR = 0x08,
+        AND = 0x20,
+        SUB = 0x28,
+        XOR = 0x30,
+        CMP = 0x38,
+        TEST = 0x84,
+        MOV = 0x88
+    };
+
+    // x86 condition codes as used by jcc
+    enum Condition : uint8_t
+    {
+        ZERO = 0x4,
+        NOT_ZERO = 0x5,
+        ABOVE = 0x7
+    };
+
+    void Byte(const uint8_t value) { code.push_back(value); }
+
+    void Bytes(std::initializer_list<uint8_t> values)
+    {
+        code.insert(code.end(), values);
+    }
+
+    template<typename T>
+    void Immediate(T value)
+    {
+        uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        code.insert(code.end(), bytes, bytes + sizeof(T));
+    }
+
+    // mov reg, imm64
+    void MovImmediate(const Register reg, const uint64_t value)
+    {
+        Bytes({0x48, static_cast<uint8_t>(0xB8 + reg)});
+        Immediate(value);
+    }
+
+    // mov eax, imm32
+    void MovEaxImmediate(const uint32_t value)
+    {
+        Byte(0xB8);
+        Immediate(value);
+    }
+
+    // mov reg, imm32
+    void MovImmediate32(const Register reg, const uint32_t value)
+    {
+        Byte(0xB8 + reg);
+        Immediate(value);
+    }
+
+    // mov dst, src on the full 32 bits
+    void MovRegister(const Register destination, const Register source) { Bytes({0x89, ModRm(source, destination)}); }
+
+    // op dst, src for byte, word or dword registers, only the low four registers have byte forms without rex
+    void Alu(const Operation operation, const Register destination, const Register source, const size_t size)
+    {
+        SizePrefix(size);
+        Bytes({static_cast<uint8_t>(operation + (size != 1)), ModRm(source, destination)});
+    }
+
+    // movzx/mov reg, [base] and mov [base], reg
+    void Load(const Register reg, const Register base, const size_t size)
+    {
+        LoadOpcode(size);
+        Byte(reg << 3 | base);
+    }
+
+    void Store(const Register base, const Register reg, const size_t size)
+    {
+        SizePrefix(size);
+        Bytes({static_cast<uint8_t>(MOV + (size != 1)), static_cast<uint8_t>(reg << 3 | base)});
+    }
+
+    // the same through [base + index]
+    void LoadIndexed(const Register reg, const Register base, const Register index, const size_t size)
+    {
+        LoadOpcode(size);
+        Bytes({static_cast<uint8_t>(reg << 3 | 0x4), static_cast<uint8_t>(index << 3 | base)});
+    }
+
+    void StoreIndexed(const Register base, const Register index, const Register reg, const size_t size)
+    {
+        SizePrefix(size);
+        Bytes({static_cast<uint8_t>(MOV + (size != 1)), static_cast<uint8_t>(reg << 3 | 0x4), static_cast<uint8_t>(index << 3 | base)});
+    }
+
+    // cmp byte [base + index], imm8
+    void CompareIndexedByte(const Register base, const Register index, const uint8_t value)
+    {
+        Bytes({0x80, 0x3C, static_cast<uint8_t>(index << 3 | base), value});
+    }
+
+    // shr/shl/and/add/cmp reg32, imm
+    void ShiftRight(const Register reg, const uint8_t amount) { Bytes({0xC1, static_cast<uint8_t>(0xE8 | reg), amount}); }
+    void ShiftLeft(const Register reg, const uint8_t amount) { Bytes({0xC1, static_cast<uint8_t>(0xE0 | reg), amount}); }
+    void AndImmediate(const Register reg, const uint32_t value) { Bytes({0x81, static_cast<uint8_t>(0xE0 | reg)}); Immediate(value); }
+    void AddImmediate(const Register reg, const uint32_t value) { Bytes({0x81, static_cast<uint8_t>(0xC0 | reg)}); Immediate(value); }
+    void CompareImmediate(const Register reg, const uint32_t value) { Bytes({0x81, static_cast<uint8_t>(0xF8 | reg)}); Immediate(value); }
+
+    // movzx reg, reg16
+    void ZeroExtendWord(const Register reg) { Bytes({0x0F, 0xB7, ModRm(reg, reg)}); }
+
+    // rol reg16, 8 or bswap reg32, h8 memory is big endian
+    void SwapBytes(const Register reg, const size_t size)
+    {
+        if (size == 2)
+            Bytes({0x66, 0xC1, static_cast<uint8_t>(0xC0 | reg), 8});
+        else if (size == 4)
+            Bytes({0x0F, static_cast<uint8_t>(0xC8 + reg)});
+    }
+
+    // pushfq, pop reg
+    void PushFlags() { Byte(0x9C); }
+    void Pop(const Register reg) { Byte(0x58 + reg); }
+
+    // call rax
+    void CallRax() { Bytes({0xFF, 0xD0}); }
+
+    // mov byte/word/dword [rcx], imm
+    void StoreByte(const uint8_t value) { Bytes({0xC6, 0x01}); Immediate(value); }
+    void StoreWord(const uint16_t value) { Bytes({0x66, 0xC7, 0x01}); Immediate(value); }
+    void StoreDword(const uint32_t value) { Bytes({0xC7, 0x01}); Immediate(value); }
+
+    // cmp byte/word/dword [rcx], imm
+    void CompareByte(const uint8_t value) { Bytes({0x80, 0x39}); Immediate(value); }
+    void CompareWord(const uint16_t value) { Bytes({0x66, 0x81, 0x39}); Immediate(value); }
+    void CompareDword(const uint32_t value) { Bytes({0x81, 0x39}); Immediate(value); }
+
+    // and/or byte [rcx], imm8
+    void AndByte(const uint8_t value) { Bytes({0x80, 0x21}); Immediate(value); }
+    void OrByte(const uint8_t value) { Bytes({0x80, 0x09}); Immediate(value); }
+
+    // test byte [rcx], imm8 and or byte [rcx], reg8
+    void TestByte(const uint8_t value) { Bytes({0xF6, 0x01}); Immediate(value); }
+    void OrByteRegister(const Register reg) { Bytes({0x08, static_cast<uint8_t>(reg << 3 | RCX)}); }
+
+    // add qword [rcx], imm32
+    void AddQword(const uint32_t value) { Bytes({0x48, 0x81, 0x01}); Immediate(value); }
+
+    // jne/jmp rel32, returns the offset to patch
+    size_t JumpNotEqual() { Bytes({0x0F, 0x85}); Immediate<int32_t>(0); return code.size() - 4; }
+    size_t Jump() { Byte(0xE9); Immediate<int32_t>(0); return code.size() - 4; }
+    size_t JumpIf(const Condition condition) { Bytes({0x0F, static_cast<uint8_t>(0x80 | condition)}); Immediate<int32_t>(0); return code.size() - 4; }
+
+    void Patch(const size_t offset, const size_t target)
+    {
+        const int32_t relative = static_cast<int32_t>(target - (offset + 4));
+        std::memcpy(&code[offset], &relative, sizeof(relative));
+    }
+
+    size_t Position() const { return code.size(); }
+    
+    std::vector<uint8_t> code;
+
+private:
+    static uint8_t ModRm(const Register reg, const Register rm) { return static_cast<uint8_t>(0xC0 | reg << 3 | rm); }
+
+    void SizePrefix(const size_t size)
+    {
+        if (size == 2)
+            Byte(0x66);
+    }
+
+    // movzx for bytes and words so the rest of the register is clean, a plain mov for dwords
+    void LoadOpcode(const size_t size)
+    {
+        if (size == 1)
+            Bytes({0x0F, 0xB6});
+        else if (size == 2)
+            Bytes({0x0F, 0xB7});
+        else
+            Byte(0x8B);
+    }
+};
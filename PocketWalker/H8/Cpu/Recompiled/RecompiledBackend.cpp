@@ -0,0 +1,84 @@
+#include "RecompiledBackend.h"
+
+#include "../Cpu.h"
+#include "../../Memory/Memory.h"
+
+RecompiledBackend::RecompiledBackend(Cpu* cpu) : cpu(cpu)
+{
+    
+}
+
+bool RecompiledBackend::Attach(const RecompiledRom& rom)
+{
+    if (Hash(cpu->ram->buffer, InstructionCache::CODE_END) != rom.hash)
+        return false;
+
+    this->rom = &rom;
+    Refresh();
+    
+    return true;
+}
+
+void RecompiledBackend::Detach()
+{
+    rom = nullptr;
+    entries.reset();
+}
+
+void RecompiledBackend::Refresh()
+{
+    if (rom == nullptr)
+        return;
+
+    entries = std::make_unique<RecompiledBlock[]>(InstructionCache::CODE_END);
+    generation = cpu->instructionCache->generation;
+    
+    for (size_t index = 0; index < rom->blockCount; index++)
+    {
+        const RecompiledBlockEntry& block = rom->blocks[index];
+
+        // hooks inside a block would never fire, leave those to the block cache
+        bool hooked = false;
+        for (uint32_t address = block.address + 1; address < block.end; address++)
+        {
+            if (cpu->HasAddressHandler(address))
+            {
+                hooked = true;
+                break;
+            }
+        }
+
+        if (!hooked)
+        {
+            entries[block.address] = block.function;
+        }
+    }
+}
+
+RecompiledBlock RecompiledBackend::Find(const uint16_t address)
+{
+    if (entries == nullptr || address >= InstructionCache::CODE_END)
+        return nullptr;
+
+    // code was written to, the generated blocks no longer match memory
+    if (generation != cpu->instructionCache->generation)
+    {
+        Detach();
+        return nullptr;
+    }
+
+    return entries[address];
+}
+
+uint32_t RecompiledBackend::Hash(const uint8_t* buffer, const size_t size)
+{
+    // fnv-1a
+    uint32_t hash = 0x811C9DC5;
+    for (size_t index = 0; index < size; index++)
+    {
+        hash ^= buffer[index];
+        hash *= 0x01000193;
+    }
+
+    return hash;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include "RecompiledRom.h"
+
+class Cpu;
+
+// dispatches to ahead-of-time compiled blocks, anything missing falls back to the block cache
+class RecompiledBackend
+{
+public:
+    RecompiledBackend(Cpu* cpu);
+
+    bool Attach(const RecompiledRom& rom);
+    void Detach();
+    void Refresh();
+
+    RecompiledBlock Find(uint16_t address);
+
+    bool IsAttached() const { return rom != nullptr; }
+
+    static uint32_t Hash(const uint8_t* buffer, size_t size);
+
+private:
+    Cpu* cpu;
+    const RecompiledRom* rom = nullptr;
+    uint32_t generation = 0;
+    
+    std::unique_ptr<RecompiledBlock[]> entries;
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class Cpu;
+
+using RecompiledBlock = size_t(*)(Cpu* cpu);
+
+struct RecompiledBlockEntry
+{
+    uint16_t address;
+    uint16_t end;
+    RecompiledBlock function;
+};
+
+// output of PocketWalker.Recompiler, only valid for the rom it was generated from
+struct RecompiledRom
+{
+    uint32_t hash;
+    const RecompiledBlockEntry* blocks;
+    size_t blockCount;
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include "RecompiledRom.h"
+#include "../Cpu.h"
+
+// helpers called from generated blocks
+namespace RecompiledRuntime
+{
+    // runs one instruction through the interpreter, returns false if the block has to stop
+    inline bool Interpret(Cpu* cpu, const uint16_t address, const uint16_t nextAddress, const uint32_t generation)
+    {
+        cpu->registers->pc = address;
+        
+        const CachedInstruction* cached = cpu->instructionCache->Fetch(address, cpu->opcodes);
+        cached->instruction->Run(cpu, cached->operands);
+
+        return cpu->registers->pc == nextAddress && !cpu->sleeping && cpu->instructionCache->generation == generation;
+    }
+
+    inline size_t Exit(Cpu* cpu, const size_t cycles, const size_t instructionCount)
+    {
+        cpu->instructionCount += instructionCount;
+        return cycles;
+    }
+}
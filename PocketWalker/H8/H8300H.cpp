@@ -1,17 +1,31 @@
 #include "H8300H.h"
 
+#include <algorithm>
+#include <format>
 #include <thread>
 
 #include "IO/IOComponent.h"
+#include "../Utilities/StateStream.h"
 
-H8300H::H8300H(uint8_t* ramBuffer): board(new Board(ramBuffer))
+H8300H::H8300H(uint8_t* ramBuffer): board(new Board(ramBuffer)), hle(new HleRegistry(board->cpu)),
+    idleLoops(new IdleLoopDetector(board->cpu, board->scheduler))
 {
     
 }
 
+H8300H::~H8300H()
+{
+    Shutdown();
+
+    delete idleLoops;
+    delete hle;
+    delete board;
+}
+
 void H8300H::StartAsync()
 {
     isRunning = true;
+    board->sci3->StartPacketAccumulator();
 
     emulatorThread = std::thread(&H8300H::EmulatorLoop, this);
 }
@@ -19,15 +33,74 @@ void H8300H::StartAsync()
 void H8300H::StartSync()
 {
     isRunning = true;
+    board->sci3->StartPacketAccumulator();
 
     EmulatorLoop();
 }
 
+void H8300H::StartSliced()
+{
+    isRunning = true;
+}
+
+bool H8300H::RunSlice(const uint64_t cycles)
+{
+    if (!isRunning)
+        return false;
+
+    const uint64_t end = std::min(board->scheduler->cycles + cycles, cycleLimit);
+    auto slice = [&]
+    {
+        while (board->scheduler->cycles < end) {
+            Step();
+
+            if (rewind != nullptr)
+                rewind->Update(board->scheduler->cycles);
+        }
+    };
+
+    if (isExceptionHandling)
+    {
+        try
+        {
+            slice();
+        }
+        catch (const std::exception& e)
+        {
+            std::println("\033[31m{}\033[0m", e.what());
+            Stop();
+        }
+    }
+    else
+    {
+        slice();
+    }
+
+    // without the accumulator thread packets go out between slices
+    board->sci3->FlushPacket();
+
+    if (board->scheduler->cycles >= cycleLimit)
+    {
+        Stop();
+    }
+
+    return isRunning;
+}
+
 void H8300H::Stop()
 {
     isRunning = false;
 }
 
+void H8300H::Shutdown()
+{
+    Stop();
+    if (emulatorThread.joinable() && emulatorThread.get_id() != std::this_thread::get_id())
+    {
+        emulatorThread.join();
+    }
+}
+
 void H8300H::Pause()
 {
     isPaused = true;
@@ -43,14 +116,17 @@ void H8300H::EmulatorLoop()
     auto loop = [&]
     {
         constexpr double SECONDS_PER_CYCLE = 1.0 / Cpu::TICKS;
-        constexpr int INSTRUCTIONS_PER_TIMING_CHECK = 1000;
-        int instructionCount = 0;
+        // checked by cycles since a fast forwarded sleep covers many cycles in one step
+        constexpr uint64_t CYCLES_PER_TIMING_CHECK = Cpu::TICKS / 1000;
+        uint64_t lastTimingCheck = 0;
 
         auto startTime = std::chrono::high_resolution_clock::now();
 
-        while (isRunning) {
+        while (isRunning && board->scheduler->cycles < cycleLimit) {
             Step();
-            instructionCount++;
+
+            if (rewind != nullptr)
+                rewind->Update(board->scheduler->cycles);
 
             if (isPaused) {
                 auto pauseStart = std::chrono::high_resolution_clock::now();
@@ -65,7 +141,11 @@ void H8300H::EmulatorLoop()
                 continue;
             }
 
-            if (instructionCount >= INSTRUCTIONS_PER_TIMING_CHECK) {
+            if (!isThrottled)
+                continue;
+
+            const auto elapsedCycles = board->scheduler->cycles;
+            if (elapsedCycles - lastTimingCheck >= CYCLES_PER_TIMING_CHECK) {
                 auto currentTime = std::chrono::high_resolution_clock::now();
                 std::chrono::duration<double> elapsedTime = currentTime - startTime;
 
@@ -75,7 +155,7 @@ void H8300H::EmulatorLoop()
                     std::this_thread::sleep_for(std::chrono::duration<double>(sleepTime));
                 }
                 
-                instructionCount = 0;
+                lastTimingCheck = elapsedCycles;
             }
         }
     };
@@ -96,16 +176,39 @@ void H8300H::EmulatorLoop()
     {
         loop();
     }
+
+    isRunning = false;
 }
 
-uint8_t H8300H::Step()
+uint64_t H8300H::Step()
 {
-    const uint8_t cpuCycles = board->cpu->Step();
-    for (auto i = 0; i < cpuCycles; i++)
+    Cpu* cpu = board->cpu;
+
+    // the pending mask is kept current by writes to the interrupt registers
+    if (cpu->interrupts->pending && !cpu->flags->interrupt)
+    {
+        cpu->UpdateInterrupts();
+    }
+    
+    if (sleepFastForward && cpu->sleeping && !cpu->HasAddressHandler(cpu->registers->pc))
+    {
+        // a sleeping cpu only wakes through an interrupt, which only an event can raise
+        return board->scheduler->SkipIdle();
+    }
+    
+    if (idleLoopSkipping && !cpu->sleeping)
     {
-        elapsedCycles++;
+        if (const uint64_t skipped = idleLoops->Skip())
+            return skipped;
+    }
 
-        Tick(elapsedCycles);
+    const uint16_t pc = cpu->registers->pc;
+    const size_t cpuCycles = board->cpu->blockExecution ? board->cpu->StepBlock() : board->cpu->Step();
+    board->scheduler->Advance(cpuCycles);
+
+    if (idleLoopSkipping)
+    {
+        idleLoops->Stepped(pc);
     }
 
     return cpuCycles;
@@ -117,18 +220,168 @@ void H8300H::SetSci3PacketTimeout(const int timeout) const
     board->sci3->SetPacketTimeout(timeout);
 }
 
-void H8300H::OnAddress(uint16_t address, const PCHandler& handler) const
+void H8300H::SetBlockExecution(const bool value) const
+{
+    board->cpu->blockExecution = value;
+}
+
+void H8300H::SetJitCompilation(const bool value) const
+{
+    board->cpu->jitCompilation = value;
+}
+
+uint64_t H8300H::GetCycles() const
+{
+    return board->scheduler->cycles;
+}
+
+uint64_t H8300H::GetWakeCycle() const
+{
+    const Cpu* cpu = board->cpu;
+    if (!cpu->sleeping || cpu->HasAddressHandler(cpu->registers->pc) || (cpu->interrupts->pending && !cpu->flags->interrupt))
+        return board->scheduler->cycles;
+
+    return std::max(board->scheduler->cycles, board->scheduler->GetActiveDeadline());
+}
+
+size_t H8300H::GetInstructionCount() const
 {
-    board->cpu->OnAddress(address, handler);
+    return board->cpu->instructionCount;
 }
 
-void H8300H::Tick(uint64_t cycles)
+void H8300H::SetSleepFastForward(const bool value)
 {
-    board->Tick(cycles);
+    sleepFastForward = value;
+}
+
+void H8300H::SetIdleLoopSkipping(const bool value)
+{
+    idleLoopSkipping = value;
+}
+
+void H8300H::SetLazyFlags(const bool value) const
+{
+    board->cpu->flags->Resolve();
+    board->cpu->flags->lazy = value;
+
+    // native blocks inline flag updates for the mode they were compiled in
+    board->cpu->blocks->Clear();
+}
+
+bool H8300H::AttachRecompiledRom(const RecompiledRom& rom) const
+{
+    // recompiled blocks are dispatched from the block path
+    if (!board->cpu->recompiled->Attach(rom))
+        return false;
+
+    board->cpu->blockExecution = true;
+    return true;
+}
 
-    if (cycles % 64 == 0 && !board->cpu->flags->interrupt)
+std::vector<uint8_t> H8300H::SaveState() const
+{
+    StateWriter state;
+    // ram and eeprom make up nearly all of it
+    state.Reserve(0x28000);
+
+    state.Write(STATE_MAGIC);
+    state.Write(STATE_VERSION);
+
+    board->SaveState(state);
+    SaveDevices(state);
+
+    return state.Take();
+}
+
+void H8300H::LoadState(const std::span<const uint8_t> data)
+{
+    StateReader state(data);
+    if (data.size() < sizeof(uint32_t) * 2 || state.Read<uint32_t>() != STATE_MAGIC)
+        throw std::runtime_error("Not a save state.");
+
+    const uint32_t version = state.Read<uint32_t>();
+    if (version != STATE_VERSION)
+        throw std::runtime_error(std::format("Save state version {} isn't supported, expected {}.", version, STATE_VERSION));
+
+    board->LoadState(state);
+    LoadDevices(state);
+
+    idleLoops->Reset();
+}
+
+void H8300H::SetRewind(const size_t budget, const uint32_t captureMilliseconds, const uint32_t keyframeMilliseconds)
+{
+    if (budget == 0)
     {
-        board->cpu->UpdateInterrupts();
+        rewind.reset();
+        return;
     }
+
+    rewind = std::make_unique<RewindBuffer>(this, budget, captureMilliseconds, keyframeMilliseconds);
 }
 
+uint64_t H8300H::RewindTo(const uint64_t cycle)
+{
+    if (rewind == nullptr)
+        throw std::runtime_error("Rewind isn't turned on.");
+
+    return rewind->RewindTo(cycle);
+}
+
+void H8300H::CopySettings(const H8300H& source)
+{
+    isExceptionHandling = source.isExceptionHandling;
+    isThrottled = source.isThrottled;
+    cycleLimit = source.cycleLimit;
+    sleepFastForward = source.sleepFastForward;
+    idleLoopSkipping = source.idleLoopSkipping;
+
+    board->cpu->blockExecution = source.board->cpu->blockExecution;
+    board->cpu->jitCompilation = source.board->cpu->jitCompilation;
+    SetLazyFlags(source.board->cpu->flags->lazy);
+}
+
+HookId H8300H::OnAddress(uint16_t address, const PCHandler& handler) const
+{
+    return board->cpu->OnAddress(address, handler);
+}
+
+bool H8300H::RemoveAddressHandler(const HookId id) const
+{
+    return board->cpu->RemoveAddressHandler(id);
+}
+
+bool H8300H::SetAddressHandlerEnabled(const HookId id, const bool enabled) const
+{
+    return board->cpu->SetAddressHandlerEnabled(id, enabled);
+}
+
+WatchId H8300H::WatchMemory(const uint16_t start, const size_t size, const uint8_t flags, const MemoryWatchHandler& handler) const
+{
+    return board->ram->Watch(start, size, flags, handler);
+}
+
+bool H8300H::UnwatchMemory(const WatchId id) const
+{
+    return board->ram->Unwatch(id);
+}
+
+bool H8300H::RegisterHle(const HleRoutine& routine) const
+{
+    return hle->Register(routine);
+}
+
+bool H8300H::SetHleEnabled(const std::string& name, const bool enabled) const
+{
+    return hle->SetEnabled(name, enabled);
+}
+
+const std::vector<std::unique_ptr<HleEntry>>& H8300H::GetHleEntries() const
+{
+    return hle->GetEntries();
+}
+
+const std::map<uint16_t, IdleLoop>& H8300H::GetIdleLoops() const
+{
+    return idleLoops->GetLoops();
+}
@@ -1,16 +1,31 @@
 #pragma once
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <thread>
+#include <vector>
 
 #include "Board/Board.h"
+#include "Board/IdleLoopDetector.h"
+#include "Hle/HleRegistry.h"
+#include "Rewind/RewindBuffer.h"
 
 class H8300H
 {
 public:
     H8300H(uint8_t* ramBuffer);
+    virtual ~H8300H();
+
+    H8300H(const H8300H&) = delete;
+    H8300H& operator=(const H8300H&) = delete;
 
     void StartAsync();
     void StartSync();
+
+    // for drivers that run the emulator themselves through RunSlice, like FleetRunner
+    void StartSliced();
+    // runs at least the given cycles, false once the emulator stopped, hit its cycle limit or threw
+    bool RunSlice(uint64_t cycles);
     void Stop();
     void Pause();
     void Resume();
@@ -19,13 +34,72 @@ public:
     bool IsPaused() const { return isPaused; }
     
     void SetExceptionHandling(const bool value) { isExceptionHandling = value; }
+
+    // unthrottled runs go as fast as the host allows instead of holding to real time
+    void SetThrottled(const bool value) { isThrottled = value; }
+
+    // the emulator loop stops by itself once this many cycles have run
+    void SetCycleLimit(const uint64_t cycles) { cycleLimit = cycles; }
+
+    uint64_t GetCycles() const;
+    // the first cycle anything can happen on, past the current one only while the cpu sleeps with no interrupt
+    // pending, UINT64_MAX when nothing but input can wake it
+    uint64_t GetWakeCycle() const;
+    size_t GetInstructionCount() const;
     void SetSci3PacketTimeout(int timeout) const;
+    void SetBlockExecution(bool value) const;
+    void SetJitCompilation(bool value) const;
+    void SetLazyFlags(bool value) const;
+    void SetSleepFastForward(bool value);
+    void SetIdleLoopSkipping(bool value);
+    bool AttachRecompiledRom(const RecompiledRom& rom) const;
+
+    // any number of handlers can share an address, the id turns one off or removes it later
+    HookId OnAddress(uint16_t address, const PCHandler& handler) const;
+    bool RemoveAddressHandler(HookId id) const;
+    bool SetAddressHandlerEnabled(HookId id, bool enabled) const;
+
+    // only pages holding a watched range pay for the check
+    WatchId WatchMemory(uint16_t start, size_t size, uint8_t flags, const MemoryWatchHandler& handler) const;
+    bool UnwatchMemory(WatchId id) const;
+
+    // only hooks the routine if its signature matches the loaded rom
+    bool RegisterHle(const HleRoutine& routine) const;
+    bool SetHleEnabled(const std::string& name, bool enabled) const;
+    const std::vector<std::unique_ptr<HleEntry>>& GetHleEntries() const;
+
+    // polling loops found so far and how much of them was skipped
+    const std::map<uint16_t, IdleLoop>& GetIdleLoops() const;
 
-    void OnAddress(uint16_t address, const PCHandler& handler) const;
+    // the whole machine, only call these while the emulator isn't stepping, between slices or before starting it,
+    // hooks, watches and settings belong to the host and stay as they are
+    std::vector<uint8_t> SaveState() const;
+    void LoadState(std::span<const uint8_t> state);
+
+    // keeps a history to step back through, a capture every captureMilliseconds of emulated time with a whole
+    // keyframe every keyframeMilliseconds and only changed pages in between, a zero budget turns it off
+    void SetRewind(size_t budget, uint32_t captureMilliseconds = 50, uint32_t keyframeMilliseconds = 1000);
+    const RewindBuffer* GetRewind() const { return rewind.get(); }
+
+    // same rules as LoadState, returns the cycle of the capture it went back to
+    uint64_t RewindTo(uint64_t cycle);
+
+    static constexpr uint32_t STATE_MAGIC = 0x54535750; // "PWST"
+    static constexpr uint32_t STATE_VERSION = 1;
 
 
 protected:
     
+    // stops the emulator and waits for its thread, boards call it before tearing down what the thread still uses
+    void Shutdown();
+
+    // how the other emulator runs, not what it is running, hooks and handlers stay with their owner
+    void CopySettings(const H8300H& source);
+
+    // state of the devices a board adds on top of the chip
+    virtual void SaveDevices(StateWriter&) const { }
+    virtual void LoadDevices(StateReader&) { }
+
     template <typename T>
     void RegisterIOComponent(T* component, Ssu::Port port, uint8_t pin)
     {
@@ -33,18 +107,24 @@ protected:
     }
 
     Board* board;
-
-    virtual void Tick(uint64_t cycles);
+    HleRegistry* hle;
+    IdleLoopDetector* idleLoops;
 
 private:
+    // steps lanes itself and reads their state between segments
+    friend class LockstepRunner;
+
     void EmulatorLoop();
-    uint8_t Step();
+    uint64_t Step();
 
     std::thread emulatorThread;
+    std::unique_ptr<RewindBuffer> rewind;
     
     bool isExceptionHandling = true;
+    bool isThrottled = true;
+    uint64_t cycleLimit = UINT64_MAX;
     bool isRunning = false;
     bool isPaused = false;
-
-    uint64_t elapsedCycles = 0;
+    bool sleepFastForward = false;
+    bool idleLoopSkipping = false;
 };
\ No newline at end of file
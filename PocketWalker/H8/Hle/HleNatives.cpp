@@ -0,0 +1,74 @@
+#include "HleNatives.h"
+
+#include <cstring>
+
+#include "../Memory/Memory.h"
+
+size_t HleNatives::Copy(Cpu* cpu, const HleRoutine& routine)
+{
+    const uint16_t destination = routine.Argument(cpu, 0);
+    const uint16_t source = routine.Argument(cpu, 1);
+    const uint16_t length = routine.Argument(cpu, 2);
+
+    Memory* ram = cpu->ram;
+
+    // a destination just past the source repeats bytes when copied forwards, memmove wouldn't
+    const bool isForwardSafe = destination <= source || destination >= source + length;
+    if (isForwardSafe && ram->IsPlain(destination, length) && ram->IsPlain(source, length))
+    {
+        std::memmove(ram->buffer + destination, ram->buffer + source, length);
+        return length;
+    }
+
+    for (uint16_t index = 0; index < length; index++)
+    {
+        ram->WriteByte(destination + index, ram->ReadByte(source + index));
+    }
+
+    return length;
+}
+
+size_t HleNatives::Fill(Cpu* cpu, const HleRoutine& routine)
+{
+    const uint16_t destination = routine.Argument(cpu, 0);
+    const uint8_t value = routine.Argument(cpu, 1) & 0xFF;
+    const uint16_t length = routine.Argument(cpu, 2);
+
+    Memory* ram = cpu->ram;
+    if (ram->IsPlain(destination, length))
+    {
+        std::memset(ram->buffer + destination, value, length);
+        return length;
+    }
+
+    for (uint16_t index = 0; index < length; index++)
+    {
+        ram->WriteByte(destination + index, value);
+    }
+
+    return length;
+}
+
+size_t HleNatives::MultiplyUnsigned(Cpu* cpu, const HleRoutine& routine)
+{
+    const uint32_t product = static_cast<uint32_t>(routine.Argument(cpu, 0)) * routine.Argument(cpu, 1);
+    *cpu->registers->Register32(routine.result) = product;
+
+    return 1;
+}
+
+size_t HleNatives::DivideUnsigned(Cpu* cpu, const HleRoutine& routine)
+{
+    const uint16_t dividend = routine.Argument(cpu, 0);
+    const uint16_t divisor = routine.Argument(cpu, 1);
+
+    // whatever the rom does on a zero divisor is the rom's business
+    if (divisor == 0)
+        return HLE_FALLBACK;
+
+    const uint16_t quotient = dividend / divisor;
+    const uint16_t remainder = dividend % divisor;
+    *cpu->registers->Register32(routine.result) = remainder << 16 | quotient;
+
+    return 1;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "HleRegistry.h"
+
+// natives for the usual helper routines, each reads its arguments through the routine's register controls
+namespace HleNatives
+{
+    // destination, source, length, copied front to back a byte at a time like a plain loop would
+    size_t Copy(Cpu* cpu, const HleRoutine& routine);
+
+    // destination, value, length
+    size_t Fill(Cpu* cpu, const HleRoutine& routine);
+
+    // 16 bit factors, 32 bit product in the result register
+    size_t MultiplyUnsigned(Cpu* cpu, const HleRoutine& routine);
+
+    // 16 bit dividend and divisor, quotient in the low and remainder in the high half of the result register
+    size_t DivideUnsigned(Cpu* cpu, const HleRoutine& routine);
+}
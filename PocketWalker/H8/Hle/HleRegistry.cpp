@@ -0,0 +1,78 @@
+#include "HleRegistry.h"
+
+#include <algorithm>
+
+#include "../Memory/Memory.h"
+
+bool HleRegistry::Register(const HleRoutine& routine)
+{
+    if (routine.address + routine.signature.size() > 0x10000)
+        return false;
+
+    if (!std::equal(routine.signature.begin(), routine.signature.end(), cpu->ram->buffer + routine.address))
+        return false;
+
+    // a second routine on the same address takes over the first one's entry
+    const auto existing = std::ranges::find_if(entries, [&routine](const auto& entry)
+    {
+        return entry->routine.address == routine.address;
+    });
+
+    if (existing != entries.end())
+    {
+        // its hook already calls into the entry
+        **existing = HleEntry(routine);
+        return true;
+    }
+
+    HleEntry* entry = entries.emplace_back(std::make_unique<HleEntry>(routine)).get();
+    cpu->OnAddress(routine.address, [this, entry](Cpu*)
+    {
+        return Call(*entry);
+    });
+
+    return true;
+}
+
+bool HleRegistry::SetEnabled(const std::string& name, const bool enabled)
+{
+    HleEntry* entry = Find(name);
+    if (entry == nullptr)
+        return false;
+
+    entry->isEnabled = enabled;
+    return true;
+}
+
+HleEntry* HleRegistry::Find(const std::string& name) const
+{
+    for (const auto& entry : entries)
+    {
+        if (entry->routine.name == name)
+            return entry.get();
+    }
+
+    return nullptr;
+}
+
+PCHandlerResult HleRegistry::Call(HleEntry& entry) const
+{
+    if (!entry.isEnabled)
+        return Continue;
+
+    const HleRoutine& routine = entry.routine;
+
+    const size_t units = routine.native(cpu, routine);
+    if (units == HLE_FALLBACK)
+    {
+        entry.fallbacks++;
+        return Continue;
+    }
+
+    entry.calls++;
+    cpu->handlerCycles += routine.baseCycles + routine.unitCycles * units;
+
+    // back to the caller as the routine's rts would
+    cpu->registers->pc = cpu->registers->PopStack();
+    return SkipInstruction;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Cpu/Cpu.h"
+
+struct HleRoutine;
+
+// units of work done natively, or HLE_FALLBACK to let the rom routine run instead
+using HleNative = std::function<size_t(Cpu* cpu, const HleRoutine& routine)>;
+
+constexpr size_t HLE_FALLBACK = SIZE_MAX;
+
+// native stand in for a rom subroutine, entered through a jsr/bsr and left through the stacked pc
+struct HleRoutine
+{
+    std::string name;
+    uint16_t address;
+
+    // bytes the rom has to hold at the address, checked before the routine is hooked
+    std::vector<uint8_t> signature;
+
+    // register controls the arguments arrive in and the result leaves in
+    std::array<uint8_t, 4> arguments;
+    uint8_t result;
+
+    // cycles charged for a call and for every unit the native reports
+    size_t baseCycles;
+    size_t unitCycles;
+
+    HleNative native;
+
+    uint16_t Argument(const Cpu* cpu, const size_t index) const
+    {
+        return *cpu->registers->Register16(arguments[index]);
+    }
+};
+
+struct HleEntry
+{
+    HleRoutine routine;
+
+    bool isEnabled = true;
+    uint64_t calls = 0;
+    uint64_t fallbacks = 0;
+};
+
+// every rom subroutine that has been swapped for native code
+class HleRegistry
+{
+public:
+    HleRegistry(Cpu* cpu) : cpu(cpu)
+    {
+
+    }
+
+    // false when the loaded rom doesn't hold the routine's signature
+    bool Register(const HleRoutine& routine);
+    bool SetEnabled(const std::string& name, bool enabled);
+
+    HleEntry* Find(const std::string& name) const;
+    const std::vector<std::unique_ptr<HleEntry>>& GetEntries() const { return entries; }
+
+private:
+    PCHandlerResult Call(HleEntry& entry) const;
+
+    Cpu* cpu;
+
+    // handlers hold on to their entry, so entries can't move
+    std::vector<std::unique_ptr<HleEntry>> entries;
+};
@@ -28,4 +28,10 @@ public:
     {
         return false;
     }
+
+    // pin only components never take part in a transfer
+    virtual bool IsSerial()
+    {
+        return true;
+    }
 };
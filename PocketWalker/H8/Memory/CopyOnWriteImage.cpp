@@ -0,0 +1,160 @@
+#include "CopyOnWriteImage.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#if _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if !_WIN32
+    // an anonymous file for the image, gone as soon as the last mapping of it is
+    int CreateImageFile()
+    {
+#ifdef __linux__
+        return memfd_create("pocketwalker-image", MFD_CLOEXEC);
+#else
+        char name[64];
+        std::snprintf(name, sizeof(name), "/pocketwalker-%d-%p", getpid(), static_cast<void*>(name));
+
+        const int descriptor = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (descriptor >= 0)
+        {
+            shm_unlink(name);
+        }
+
+        return descriptor;
+#endif
+    }
+#endif
+}
+
+CopyOnWriteView::~CopyOnWriteView()
+{
+    Release();
+}
+
+CopyOnWriteView::CopyOnWriteView(CopyOnWriteView&& other) noexcept :
+    data(std::exchange(other.data, nullptr)), size(other.size), isMapped(other.isMapped)
+{
+
+}
+
+CopyOnWriteView& CopyOnWriteView::operator=(CopyOnWriteView&& other) noexcept
+{
+    if (this != &other)
+    {
+        Release();
+        data = std::exchange(other.data, nullptr);
+        size = other.size;
+        isMapped = other.isMapped;
+    }
+
+    return *this;
+}
+
+void CopyOnWriteView::Release()
+{
+    if (data == nullptr)
+        return;
+
+    if (!isMapped)
+    {
+        delete[] data;
+    }
+    else
+    {
+#if _WIN32
+        UnmapViewOfFile(data);
+#else
+        munmap(data, size);
+#endif
+    }
+
+    data = nullptr;
+}
+
+CopyOnWriteImage::CopyOnWriteImage(const uint8_t* buffer, const size_t size) : size(size)
+{
+#if _WIN32
+    mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), nullptr);
+    if (mapping != nullptr)
+    {
+        image = static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size));
+        if (image == nullptr)
+        {
+            CloseHandle(mapping);
+            mapping = nullptr;
+        }
+    }
+#else
+    descriptor = CreateImageFile();
+    if (descriptor >= 0 && ftruncate(descriptor, static_cast<off_t>(size)) == 0)
+    {
+        void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        image = view == MAP_FAILED ? nullptr : static_cast<uint8_t*>(view);
+    }
+
+    if (image == nullptr && descriptor >= 0)
+    {
+        close(descriptor);
+        descriptor = -1;
+    }
+#endif
+
+    if (image == nullptr)
+    {
+        fallback = std::make_unique<uint8_t[]>(size);
+        image = fallback.get();
+    }
+
+    std::memcpy(image, buffer, size);
+}
+
+CopyOnWriteImage::~CopyOnWriteImage()
+{
+    if (fallback != nullptr)
+        return;
+
+    // views already handed out keep their pages after the image goes
+#if _WIN32
+    UnmapViewOfFile(image);
+    CloseHandle(mapping);
+#else
+    munmap(image, size);
+    close(descriptor);
+#endif
+}
+
+CopyOnWriteView CopyOnWriteImage::Map() const
+{
+    if (fallback == nullptr)
+    {
+#if _WIN32
+        if (void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, size))
+            return CopyOnWriteView(static_cast<uint8_t*>(view), size, true);
+#else
+        void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+        if (view != MAP_FAILED)
+            return CopyOnWriteView(static_cast<uint8_t*>(view), size, true);
+#endif
+    }
+
+    const auto copy = new uint8_t[size];
+    std::memcpy(copy, image, size);
+
+    return CopyOnWriteView(copy, size, false);
+}
+
+bool CopyOnWriteImage::Matches(const uint8_t* buffer) const
+{
+    return std::memcmp(image, buffer, size) == 0;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// a private writable copy of an image, pages stay shared with the image until the first write to them
+class CopyOnWriteView
+{
+public:
+    CopyOnWriteView() = default;
+    CopyOnWriteView(uint8_t* data, size_t size, bool isMapped) : data(data), size(size), isMapped(isMapped) {}
+    ~CopyOnWriteView();
+
+    CopyOnWriteView(CopyOnWriteView&& other) noexcept;
+    CopyOnWriteView& operator=(CopyOnWriteView&& other) noexcept;
+    CopyOnWriteView(const CopyOnWriteView&) = delete;
+    CopyOnWriteView& operator=(const CopyOnWriteView&) = delete;
+
+    uint8_t* GetData() const { return data; }
+
+    // false when the platform couldn't map the image and the view is a plain copy
+    bool IsShared() const { return isMapped; }
+
+private:
+    void Release();
+
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    bool isMapped = false;
+};
+
+// a frozen copy of a buffer held by the os, any number of views map it privately so copying a page is left
+// to the first write that lands on it, platforms without shared mappings copy the whole image per view
+class CopyOnWriteImage
+{
+public:
+    CopyOnWriteImage(const uint8_t* buffer, size_t size);
+    ~CopyOnWriteImage();
+
+    CopyOnWriteImage(const CopyOnWriteImage&) = delete;
+    CopyOnWriteImage& operator=(const CopyOnWriteImage&) = delete;
+
+    CopyOnWriteView Map() const;
+
+    // the buffer still holds what the image was taken from
+    bool Matches(const uint8_t* buffer) const;
+
+    size_t GetSize() const { return size; }
+
+private:
+    size_t size;
+
+    // read only view of the image, or the heap copy without mappings
+    uint8_t* image = nullptr;
+    std::unique_ptr<uint8_t[]> fallback;
+
+#if _WIN32
+    void* mapping = nullptr;
+#else
+    int descriptor = -1;
+#endif
+};
@@ -1,5 +1,6 @@
 #include "Memory.h"
 
+#include <algorithm>
 #include <print>
 
 std::string Memory::ReadString(uint16_t address, size_t size)
@@ -13,85 +14,158 @@ std::string Memory::ReadString(uint16_t address, size_t size)
     return data;
 }
 
-uint8_t Memory::ReadByte(uint16_t address, bool isFromHardware) const
+void Memory::OnWriteRange(const uint16_t start, const uint16_t end, const MemoryRangeHandler& onWrite)
 {
-    address &= 0xFFFF;
-    const uint8_t value = this->buffer[address];
-    
-    if (const auto it = readHandlers.find(address); it != readHandlers.end())
+    for (size_t page = 0; page < MEMORY_PAGE_COUNT; page++)
     {
-        it->second(value, isFromHardware);
+        pageFlags[page] &= ~PAGE_WRITE_RANGE;
     }
     
-    return value;
+    writeRangeStart = start;
+    writeRangeEnd = end;
+    writeRangeHandler = onWrite;
+
+    for (size_t page = start >> MEMORY_PAGE_SHIFT; page < MEMORY_PAGE_COUNT && page << MEMORY_PAGE_SHIFT < end; page++)
+    {
+        pageFlags[page] |= PAGE_WRITE_RANGE;
+    }
 }
 
-uint16_t Memory::ReadShort(uint16_t address, bool isFromHardware) const
+WatchId Memory::Watch(const uint16_t start, const size_t size, const uint8_t flags, const MemoryWatchHandler& handler)
 {
-    address &= 0xFFFF;
-    const uint16_t value = this->buffer[address] << 8 | this->buffer[address + 1];
-    
-    if (const auto it = readHandlers.find(address); it != readHandlers.end())
+    const WatchId id = nextWatchId++;
+    watches.push_back({id, start, std::min<uint32_t>(start + size, 0x10000), flags, handler});
+    UpdateWatchFlags();
+
+    return id;
+}
+
+bool Memory::Unwatch(const WatchId id)
+{
+    if (std::erase_if(watches, [id](const MemoryWatch& watch) { return watch.id == id; }) == 0)
+        return false;
+
+    UpdateWatchFlags();
+    return true;
+}
+
+void Memory::UpdateWatchFlags()
+{
+    for (size_t page = 0; page < MEMORY_PAGE_COUNT; page++)
     {
-        it->second(value, isFromHardware);
+        pageFlags[page] &= ~(PAGE_READ_WATCH | PAGE_WRITE_WATCH);
+    }
+
+    for (const MemoryWatch& watch : watches)
+    {
+        const uint8_t flag = (watch.flags & WATCH_READ ? PAGE_READ_WATCH : 0) | (watch.flags & (WATCH_WRITE | WATCH_CHANGE) ? PAGE_WRITE_WATCH : 0);
+
+        // accesses are only checked against the page they start on, a word or long can start up to 3 bytes before the range
+        const size_t first = (watch.start >= 3 ? watch.start - 3 : 0) >> MEMORY_PAGE_SHIFT;
+        for (size_t page = first; page < MEMORY_PAGE_COUNT && page << MEMORY_PAGE_SHIFT < watch.end; page++)
+        {
+            pageFlags[page] |= flag;
+        }
     }
-    
-    return value;
 }
 
-uint32_t Memory::ReadInt(uint16_t address, bool isFromHardware) const
+MemoryPage& Memory::GetPage(const uint16_t address)
 {
-    address &= 0xFFFF;
-    
-    const uint32_t value = this->buffer[address] << 24 | this->buffer[address + 1] << 16 | this->buffer[address + 2] << 8 | this->buffer[address + 3];
-   
-    if (const auto it = readHandlers.find(address); it != readHandlers.end())
+    std::unique_ptr<MemoryPage>& page = pages[address >> MEMORY_PAGE_SHIFT];
+    if (page == nullptr)
     {
-        it->second(value, isFromHardware);
+        page = std::make_unique<MemoryPage>();
     }
-    
-    return value;
+
+    return *page;
 }
 
-void Memory::WriteByte(uint16_t address, const uint8_t value, bool isFromHardware) const
+void Memory::OnReadAccess(const uint16_t address, const size_t size, const bool isFromHardware) const
 {
-    if (!isFromHardware && IsReadOnlyAddress(address))
-        return;
-    
-    this->buffer[address] = value;
+    const uint8_t flags = pageFlags[address >> MEMORY_PAGE_SHIFT];
+
+    if (flags & PAGE_READ_HANDLERS)
+    {
+        const MemoryHandler& handler = pages[address >> MEMORY_PAGE_SHIFT]->readHandlers[address & 0xFF];
+        if (handler != nullptr)
+        {
+            handler(Peek(address, size), isFromHardware);
+        }
+    }
 
-    if (const auto it = writeHandlers.find(address); it != writeHandlers.end())
+    if (flags & PAGE_READ_WATCH)
     {
-        it->second(value, isFromHardware);
+        const uint32_t value = Peek(address, size);
+        OnWatchAccess(address, size, value, value, WATCH_READ);
     }
 }
 
-void Memory::WriteShort(uint16_t address, uint16_t value, bool isFromHardware) const
+void Memory::OnWriteAccess(const uint16_t address, const size_t size, const uint32_t previous, const uint32_t value, const bool isFromHardware) const
 {
-    if (!isFromHardware && IsReadOnlyAddress(address))
-        return;
-    
-    this->buffer[address] = value >> 8 & 0xFF;
-    this->buffer[address + 1] = value & 0xFF;
+    const uint8_t flags = pageFlags[address >> MEMORY_PAGE_SHIFT];
     
-    if (const auto it = writeHandlers.find(address); it != writeHandlers.end())
+    if (flags & PAGE_WRITE_RANGE && address >= writeRangeStart && address < writeRangeEnd)
     {
-        it->second(value, isFromHardware);
+        writeRangeHandler(address, size);
+    }
+
+    if (flags & PAGE_WRITE_HANDLERS)
+    {
+        const MemoryHandler& handler = pages[address >> MEMORY_PAGE_SHIFT]->writeHandlers[address & 0xFF];
+        if (handler != nullptr)
+        {
+            handler(value, isFromHardware);
+        }
+    }
+
+    // the rest of a word or long only reaches handlers that asked for every write covering them
+    for (size_t offset = 1; offset < size; offset++)
+    {
+        const uint16_t byteAddress = address + offset;
+        if (!(pageFlags[byteAddress >> MEMORY_PAGE_SHIFT] & PAGE_WRITE_HANDLERS))
+            continue;
+
+        const MemoryPage& page = *pages[byteAddress >> MEMORY_PAGE_SHIFT];
+        if (page.coveringWrites.test(byteAddress & 0xFF) && page.writeHandlers[byteAddress & 0xFF] != nullptr)
+        {
+            page.writeHandlers[byteAddress & 0xFF](value >> (size - 1 - offset) * 8 & 0xFF, isFromHardware);
+        }
+    }
+
+    if (flags & PAGE_WRITE_WATCH)
+    {
+        OnWatchAccess(address, size, previous, value, WATCH_WRITE | WATCH_CHANGE);
     }
 }
 
-void Memory::WriteInt(uint16_t address, uint32_t value, bool isFromHardware) const
+void Memory::OnWatchAccess(const uint16_t address, const size_t size, const uint32_t previous, const uint32_t value, const uint8_t flags) const
 {
-    if (!isFromHardware && IsReadOnlyAddress(address))
-        return;
-    
-    this->buffer[address] = value >> 24 & 0xFF;
-    this->buffer[address + 1] = value >> 16 & 0xFF;
-    this->buffer[address + 2] = value >> 8 & 0xFF;
-    this->buffer[address + 3] = value & 0xFF;
-    
-    if (const auto it = writeHandlers.find(address); it != writeHandlers.end())
+    // handlers can add and remove watches themselves, so the list is indexed again for each one
+    for (size_t index = 0; index < watches.size(); index++)
     {
-        it->second(value, isFromHardware);
+        const MemoryWatch& watch = watches[index];
+        if (!(watch.flags & flags) || address + size <= watch.start || address >= watch.end)
+            continue;
+
+        if ((watch.flags & flags) == WATCH_CHANGE)
+        {
+            // a change watch only cares about the bytes inside its own range
+            bool isChanged = false;
+            for (size_t offset = 0; offset < size; offset++)
+            {
+                const uint32_t byteAddress = address + offset;
+                const size_t shift = (size - 1 - offset) * 8;
+                if (byteAddress >= watch.start && byteAddress < watch.end && (previous >> shift & 0xFF) != (value >> shift & 0xFF))
+                {
+                    isChanged = true;
+                }
+            }
+
+            if (!isChanged)
+                continue;
+        }
+
+        const MemoryWatchHandler handler = watch.handler;
+        handler(address, size, previous, value);
     }
-}
\ No newline at end of file
+}
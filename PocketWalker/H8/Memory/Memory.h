@@ -1,13 +1,64 @@
 #pragma once
+#include <array>
+#include <bitset>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
-#include <unordered_set>
+#include <vector>
 
 #include "MemoryAccessor.h"
 
 // TODO create separate hardware/software read/write functions
+// runs once per access that starts on the handler's address with the whole byte, word or long, handlers added with
+// OnWriteCovering also run for word and long writes that only cover their address, with the byte that landed on it
 using MemoryHandler = std::function<void(uint32_t, bool isFromHardware)>;
+using MemoryRangeHandler = std::function<void(uint16_t address, size_t size)>;
+
+// previous and value are the whole access, for reads they're the same
+using MemoryWatchHandler = std::function<void(uint16_t address, size_t size, uint32_t previous, uint32_t value)>;
+using WatchId = uint32_t;
+
+constexpr size_t MEMORY_PAGE_SHIFT = 8;
+constexpr size_t MEMORY_PAGE_SIZE = 1 << MEMORY_PAGE_SHIFT;
+constexpr size_t MEMORY_PAGE_COUNT = 0x10000 >> MEMORY_PAGE_SHIFT;
+
+// a page with no flags set is plain memory and skips every handler lookup
+enum MemoryPageFlags : uint8_t
+{
+    PAGE_READ_HANDLERS = 1 << 0,
+    PAGE_WRITE_HANDLERS = 1 << 1,
+    PAGE_READ_ONLY = 1 << 2,
+    PAGE_WRITE_RANGE = 1 << 3,
+    PAGE_READ_WATCH = 1 << 4,
+    PAGE_WRITE_WATCH = 1 << 5
+};
+
+enum MemoryWatchFlags : uint8_t
+{
+    WATCH_READ = 1 << 0,
+    WATCH_WRITE = 1 << 1,
+    // only writes that leave a different value somewhere in the range
+    WATCH_CHANGE = 1 << 2
+};
+
+struct MemoryWatch
+{
+    WatchId id;
+    uint16_t start;
+    uint32_t end;
+    uint8_t flags;
+    MemoryWatchHandler handler;
+};
+
+// per-register state for a page that holds mmio
+struct MemoryPage
+{
+    std::array<MemoryHandler, MEMORY_PAGE_SIZE> readHandlers;
+    std::array<MemoryHandler, MEMORY_PAGE_SIZE> writeHandlers;
+    std::bitset<MEMORY_PAGE_SIZE> coveringWrites;
+    std::bitset<MEMORY_PAGE_SIZE> readOnly;
+};
 
 class Memory
 {
@@ -20,60 +71,220 @@ public:
     Memory(size_t size) 
     {
         this->buffer = new uint8_t[size]();
+        ownedBuffer.reset(this->buffer);
     }
     
     void OnRead(uint16_t address, const MemoryHandler& onRead)
     {
-        readHandlers[address] = onRead;
+        GetPage(address).readHandlers[address & 0xFF] = onRead;
+        pageFlags[address >> MEMORY_PAGE_SHIFT] |= PAGE_READ_HANDLERS;
     }
     
     void OnWrite(uint16_t address, const MemoryHandler& onWrite)
     {
-        writeHandlers[address] = onWrite;
+        GetPage(address).writeHandlers[address & 0xFF] = onWrite;
+        pageFlags[address >> MEMORY_PAGE_SHIFT] |= PAGE_WRITE_HANDLERS;
+    }
+
+    // for registers whose state depends on every write landing on them, like the interrupt enables and flags
+    void OnWriteCovering(const uint16_t address, const MemoryHandler& onWrite)
+    {
+        OnWrite(address, onWrite);
+        GetPage(address).coveringWrites.set(address & 0xFF);
     }
 
+    void OnWriteRange(uint16_t start, uint16_t end, const MemoryRangeHandler& onWrite);
+
+    // any number of watches can overlap, only accesses through Read/Write see them and not accessors
+    WatchId Watch(uint16_t start, size_t size, uint8_t flags, const MemoryWatchHandler& handler);
+    bool Unwatch(WatchId id);
+
     template<typename T>
     MemoryAccessor<T> CreateAccessor(uint16_t address) {
-        return MemoryAccessor<T>(this, address);
+        return MemoryAccessor<T>(buffer, address);
     }
 
     std::string ReadString(uint16_t address, size_t size);
-    uint8_t ReadByte(uint16_t address, bool isFromHardware = false) const;
-    uint16_t ReadShort(uint16_t address, bool isFromHardware = false) const;
-    uint32_t ReadInt(uint16_t address, bool isFromHardware = false) const;
     
-    void WriteByte(uint16_t address, uint8_t value, bool isFromHardware = false) const;
-    void WriteShort(uint16_t address, uint16_t value, bool isFromHardware = false) const;
-    void WriteInt(uint16_t address, uint32_t value, bool isFromHardware = false) const;
+    uint8_t ReadByte(const uint16_t address, const bool isFromHardware = false) const
+    {
+        // handlers run first so lazily updated registers can refresh before being read
+        if (pageFlags[address >> MEMORY_PAGE_SHIFT] & (PAGE_READ_HANDLERS | PAGE_READ_WATCH))
+            OnReadAccess(address, 1, isFromHardware);
+        
+        return this->buffer[address];
+    }
+    
+    uint16_t ReadShort(const uint16_t address, const bool isFromHardware = false) const
+    {
+        if (pageFlags[address >> MEMORY_PAGE_SHIFT] & (PAGE_READ_HANDLERS | PAGE_READ_WATCH))
+            OnReadAccess(address, 2, isFromHardware);
+        
+        return this->buffer[address] << 8 | this->buffer[address + 1];
+    }
+    
+    uint32_t ReadInt(const uint16_t address, const bool isFromHardware = false) const
+    {
+        if (pageFlags[address >> MEMORY_PAGE_SHIFT] & (PAGE_READ_HANDLERS | PAGE_READ_WATCH))
+            OnReadAccess(address, 4, isFromHardware);
+        
+        return this->buffer[address] << 24 | this->buffer[address + 1] << 16 | this->buffer[address + 2] << 8 | this->buffer[address + 3];
+    }
+    
+    void WriteByte(const uint16_t address, const uint8_t value, const bool isFromHardware = false) const
+    {
+        const uint8_t flags = pageFlags[address >> MEMORY_PAGE_SHIFT];
+        if (flags & PAGE_READ_ONLY && !isFromHardware && IsReadOnlyAddress(address))
+            return;
+
+        const uint32_t previous = flags & PAGE_WRITE_WATCH ? Peek(address, 1) : 0;
+        this->buffer[address] = value;
+
+        if (flags)
+            OnWriteAccess(address, 1, previous, value, isFromHardware);
+    }
+    
+    void WriteShort(const uint16_t address, const uint16_t value, const bool isFromHardware = false) const
+    {
+        const uint8_t flags = GetAccessFlags(address, 2);
+        if (flags & PAGE_READ_ONLY && !isFromHardware && IsReadOnlyAddress(address))
+            return;
+
+        const uint32_t previous = flags & PAGE_WRITE_WATCH ? Peek(address, 2) : 0;
+        this->buffer[address] = value >> 8 & 0xFF;
+        this->buffer[address + 1] = value & 0xFF;
+
+        if (flags)
+            OnWriteAccess(address, 2, previous, value, isFromHardware);
+    }
+    
+    void WriteInt(const uint16_t address, const uint32_t value, const bool isFromHardware = false) const
+    {
+        const uint8_t flags = GetAccessFlags(address, 4);
+        if (flags & PAGE_READ_ONLY && !isFromHardware && IsReadOnlyAddress(address))
+            return;
+
+        const uint32_t previous = flags & PAGE_WRITE_WATCH ? Peek(address, 4) : 0;
+        this->buffer[address] = value >> 24 & 0xFF;
+        this->buffer[address + 1] = value >> 16 & 0xFF;
+        this->buffer[address + 2] = value >> 8 & 0xFF;
+        this->buffer[address + 3] = value & 0xFF;
+
+        if (flags)
+            OnWriteAccess(address, 4, previous, value, isFromHardware);
+    }
 
     void AddReadOnlyAddresses(const std::vector<uint16_t>& locations)
     {
         for (const auto addr : locations)
         {
-            readOnlyAddresses.insert(addr);
+            AddReadOnlyAddress(addr);
         }
     }
 
     void AddReadOnlyAddress(uint16_t address)
     {
-        readOnlyAddresses.insert(address);
+        GetPage(address).readOnly.set(address & 0xFF);
+        pageFlags[address >> MEMORY_PAGE_SHIFT] |= PAGE_READ_ONLY;
     }
 
     void RemoveReadOnlyAddress(uint16_t address)
     {
-        readOnlyAddresses.erase(address);
+        const uint8_t page = address >> MEMORY_PAGE_SHIFT;
+        if (pages[page] == nullptr)
+            return;
+
+        pages[page]->readOnly.reset(address & 0xFF);
+        if (pages[page]->readOnly.none())
+        {
+            pageFlags[page] &= ~PAGE_READ_ONLY;
+        }
+    }
+
+    // no handlers or read only registers anywhere in the range, bulk copies can go straight to the buffer
+    bool IsPlain(const uint16_t address, const size_t size) const
+    {
+        if (address + size > 0x10000)
+            return false;
+
+        for (size_t page = address >> MEMORY_PAGE_SHIFT; page << MEMORY_PAGE_SHIFT < address + size; page++)
+        {
+            if (pageFlags[page])
+                return false;
+        }
+
+        return true;
+    }
+
+    bool HasReadHandler(const uint16_t address) const
+    {
+        const uint8_t page = address >> MEMORY_PAGE_SHIFT;
+        return pageFlags[page] & PAGE_READ_HANDLERS && pages[page]->readHandlers[address & 0xFF] != nullptr;
     }
 
+    bool HasReadWatch(const uint16_t address) const
+    {
+        return pageFlags[address >> MEMORY_PAGE_SHIFT] & PAGE_READ_WATCH;
+    }
+
+    bool IsWatched(const uint16_t address, const size_t size) const
+    {
+        for (size_t page = address >> MEMORY_PAGE_SHIFT; page < MEMORY_PAGE_COUNT && page << MEMORY_PAGE_SHIFT < address + size; page++)
+        {
+            if (pageFlags[page] & (PAGE_READ_WATCH | PAGE_WRITE_WATCH))
+                return true;
+        }
+
+        return false;
+    }
+
+    // a flag byte per page, zero means plain memory, generated code reads it to decide on the fast path
+    const uint8_t* GetPageFlags() const { return pageFlags.data(); }
+
     bool IsReadOnlyAddress(uint16_t address) const
     {
-        return readOnlyAddresses.contains(address);
+        const uint8_t page = address >> MEMORY_PAGE_SHIFT;
+        return pageFlags[page] & PAGE_READ_ONLY && pages[page]->readOnly.test(address & 0xFF);
     }
 
     std::string name = "Memory";
     uint8_t* buffer;
 
 private:
-    std::unordered_map<uint16_t, MemoryHandler> readHandlers;
-    std::unordered_map<uint16_t, MemoryHandler> writeHandlers;
-    std::unordered_set<uint16_t> readOnlyAddresses;
+    // only set when the memory made its own buffer, one handed in belongs to whoever made it
+    std::unique_ptr<uint8_t[]> ownedBuffer;
+
+    MemoryPage& GetPage(uint16_t address);
+    void UpdateWatchFlags();
+
+    uint32_t Peek(uint16_t address, size_t size) const
+    {
+        uint32_t value = 0;
+        for (size_t index = 0; index < size; index++)
+        {
+            value = value << 8 | this->buffer[address + index];
+        }
+
+        return value;
+    }
+
+    // the flags of the pages a word or long write touches, it only crosses into the next one from the end of a page
+    uint8_t GetAccessFlags(const uint16_t address, const size_t size) const
+    {
+        return pageFlags[address >> MEMORY_PAGE_SHIFT] | pageFlags[static_cast<uint16_t>(address + size - 1) >> MEMORY_PAGE_SHIFT];
+    }
+
+    void OnReadAccess(uint16_t address, size_t size, bool isFromHardware) const;
+    void OnWriteAccess(uint16_t address, size_t size, uint32_t previous, uint32_t value, bool isFromHardware) const;
+    void OnWatchAccess(uint16_t address, size_t size, uint32_t previous, uint32_t value, uint8_t flags) const;
+    
+    std::array<uint8_t, MEMORY_PAGE_COUNT> pageFlags = {};
+    std::array<std::unique_ptr<MemoryPage>, MEMORY_PAGE_COUNT> pages;
+
+    uint16_t writeRangeStart = 0;
+    uint16_t writeRangeEnd = 0;
+    MemoryRangeHandler writeRangeHandler;
+
+    std::vector<MemoryWatch> watches;
+    WatchId nextWatchId = 1;
 };
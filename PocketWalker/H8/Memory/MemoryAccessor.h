@@ -1,14 +1,14 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
-#include <functional>
-#include <unordered_map>
-
-class Memory;
 
+// typed view of an on-chip register, reads and writes go straight to the backing buffer
+// without running memory handlers, peripherals use these for their own registers and
+// go through Memory for anything another component reacts to
 template<typename T>
 class MemoryAccessor {
 public:
-    MemoryAccessor(Memory* mem, uint16_t addr) : memory(mem), address(addr) {}
+    MemoryAccessor(uint8_t* buffer, uint16_t addr) : address(addr), data(buffer + addr) {}
     
     MemoryAccessor& operator=(T value)
     {
@@ -62,8 +62,26 @@ public:
     uint16_t address;
     
 private:
-    Memory* memory;
+    uint8_t* data;
 
-    T read() const;
-    void write(T value);
-};
\ No newline at end of file
+    // registers are stored big endian, same as the cpu sees them
+    T read() const
+    {
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); i++)
+        {
+            value = static_cast<T>(value << 8 | data[i]);
+        }
+        
+        return value;
+    }
+    
+    void write(T value)
+    {
+        for (size_t i = sizeof(T); i > 0; i--)
+        {
+            data[i - 1] = static_cast<uint8_t>(value);
+            value = static_cast<T>(value >> 8);
+        }
+    }
+};
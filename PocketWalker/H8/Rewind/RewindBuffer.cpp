@@ -0,0 +1,166 @@
+#include "RewindBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include "../H8300H.h"
+
+RewindBuffer::RewindBuffer(H8300H* emulator, const size_t budget, const uint32_t captureMilliseconds, const uint32_t keyframeMilliseconds) :
+    emulator(emulator), budget(budget),
+    captureInterval(std::max<uint64_t>(static_cast<uint64_t>(Cpu::TICKS) * captureMilliseconds / 1000, 1)),
+    keyframeInterval(static_cast<uint64_t>(Cpu::TICKS) * keyframeMilliseconds / 1000)
+{
+
+}
+
+void RewindBuffer::Capture()
+{
+    const uint64_t cycles = emulator->GetCycles();
+
+    // a state loaded from somewhere else can put the emulator before everything recorded
+    if (!captures.empty() && cycles < captures.back().cycles)
+    {
+        Clear();
+    }
+
+    std::vector<uint8_t> state = emulator->SaveState();
+
+    // a state that changed size shifts every page after the change, a keyframe is smaller than that delta
+    if (captures.empty() || cycles >= nextKeyframe || state.size() != lastState.size())
+    {
+        Push({cycles, true, state, {}});
+        nextKeyframe = cycles + keyframeInterval;
+    }
+    else
+    {
+        Push(CreateDelta(cycles, state));
+    }
+
+    lastState = std::move(state);
+    nextCapture = cycles + captureInterval;
+}
+
+uint64_t RewindBuffer::RewindTo(const uint64_t cycle)
+{
+    const auto next = std::upper_bound(captures.begin(), captures.end(), cycle, [](const uint64_t value, const RewindCapture& capture)
+    {
+        return value < capture.cycles;
+    });
+
+    if (next == captures.begin())
+    {
+        if (captures.empty())
+            throw std::runtime_error("Nothing has been recorded to rewind to.");
+
+        throw std::runtime_error(std::format("Can't rewind to cycle {}, the oldest capture is at {}.", cycle, captures.front().cycles));
+    }
+
+    const auto target = next - 1;
+    auto keyframe = target;
+    while (!keyframe->isKeyframe)
+    {
+        --keyframe;
+    }
+
+    std::vector<uint8_t> state = keyframe->data;
+    for (auto delta = keyframe + 1; delta != next; ++delta)
+    {
+        const uint8_t* page = delta->data.data();
+        for (const uint32_t index : delta->pageIndices)
+        {
+            const size_t offset = index * PAGE_SIZE;
+            const size_t length = std::min(PAGE_SIZE, state.size() - offset);
+            std::memcpy(state.data() + offset, page, length);
+            page += length;
+        }
+    }
+
+    emulator->LoadState(state);
+
+    const uint64_t cycles = target->cycles;
+    nextKeyframe = keyframe->cycles + keyframeInterval;
+    nextCapture = cycles + captureInterval;
+
+    const size_t kept = next - captures.begin();
+    while (captures.size() > kept)
+    {
+        footprint -= captures.back().GetFootprint();
+        if (captures.back().isKeyframe)
+        {
+            keyframes--;
+        }
+
+        captures.pop_back();
+    }
+
+    lastState = std::move(state);
+    return cycles;
+}
+
+void RewindBuffer::Clear()
+{
+    captures.clear();
+    keyframes = 0;
+    footprint = 0;
+    lastState.clear();
+    nextCapture = 0;
+    nextKeyframe = 0;
+}
+
+uint64_t RewindBuffer::GetOldestCycle() const
+{
+    return captures.empty() ? 0 : captures.front().cycles;
+}
+
+RewindCapture RewindBuffer::CreateDelta(const uint64_t cycles, const std::vector<uint8_t>& state) const
+{
+    // changed pages come from comparing states, not from marking them in Memory::Write*, peripherals write their
+    // registers through raw accessors, hle natives memmove and memset ram and the lockstep runner stores straight
+    // into it, none of which go through there
+    RewindCapture delta = {cycles, false, {}, {}};
+    for (size_t offset = 0; offset < state.size(); offset += PAGE_SIZE)
+    {
+        const size_t length = std::min(PAGE_SIZE, state.size() - offset);
+        if (std::memcmp(state.data() + offset, lastState.data() + offset, length) == 0)
+            continue;
+
+        delta.pageIndices.push_back(static_cast<uint32_t>(offset / PAGE_SIZE));
+        delta.data.insert(delta.data.end(), state.begin() + offset, state.begin() + offset + length);
+    }
+
+    delta.data.shrink_to_fit();
+    delta.pageIndices.shrink_to_fit();
+    return delta;
+}
+
+void RewindBuffer::Push(RewindCapture capture)
+{
+    footprint += capture.GetFootprint();
+    if (capture.isKeyframe)
+    {
+        keyframes++;
+    }
+
+    captures.push_back(std::move(capture));
+    Evict();
+}
+
+void RewindBuffer::Evict()
+{
+    // deltas mean nothing without the keyframe before them, so they go with it, the newest keyframe always stays
+    while (footprint > budget && keyframes > 1)
+    {
+        do
+        {
+            footprint -= captures.front().GetFootprint();
+            if (captures.front().isKeyframe)
+            {
+                keyframes--;
+            }
+
+            captures.pop_front();
+        } while (!captures.front().isKeyframe);
+    }
+}
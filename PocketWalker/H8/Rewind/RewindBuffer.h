@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class H8300H;
+
+// a point the emulator can go back to, keyframes hold a whole save state and deltas only the pages of it
+// that changed since the capture before them
+struct RewindCapture
+{
+    uint64_t cycles;
+    bool isKeyframe;
+
+    // keyframes keep the state as is, deltas keep the changed pages back to back in the order of pageIndices
+    std::vector<uint8_t> data;
+    std::vector<uint32_t> pageIndices;
+
+    size_t GetFootprint() const { return sizeof(RewindCapture) + data.capacity() + pageIndices.capacity() * sizeof(uint32_t); }
+};
+
+// a history of save states held to a memory budget, the oldest keyframe and its deltas go first once it's spent
+class RewindBuffer
+{
+public:
+    RewindBuffer(H8300H* emulator, size_t budget, uint32_t captureMilliseconds, uint32_t keyframeMilliseconds);
+
+    // called between steps, captures once the interval since the last capture has passed
+    void Update(const uint64_t cycles)
+    {
+        if (cycles >= nextCapture)
+            Capture();
+    }
+
+    void Capture();
+
+    // back to the latest capture at or before the cycle, later captures are dropped since the run goes
+    // somewhere else from there, returns the cycle it landed on
+    uint64_t RewindTo(uint64_t cycle);
+
+    void Clear();
+
+    uint64_t GetOldestCycle() const;
+    size_t GetCaptureCount() const { return captures.size(); }
+    size_t GetKeyframeCount() const { return keyframes; }
+    size_t GetFootprint() const { return footprint; }
+    size_t GetBudget() const { return budget; }
+
+    // pages are compared as the state is laid out, ram lands on them shifted by the few bytes in front of it
+    static constexpr size_t PAGE_SIZE = 0x100;
+
+private:
+    RewindCapture CreateDelta(uint64_t cycles, const std::vector<uint8_t>& state) const;
+    void Push(RewindCapture capture);
+    void Evict();
+
+    H8300H* emulator;
+    size_t budget;
+    uint64_t captureInterval;
+    uint64_t keyframeInterval;
+
+    std::deque<RewindCapture> captures;
+    size_t keyframes = 0;
+    size_t footprint = 0;
+
+    // the state at the newest capture, what the next delta is taken against
+    std::vector<uint8_t> lastState;
+    uint64_t nextCapture = 0;
+    uint64_t nextKeyframe = 0;
+};
@@ -3,6 +3,7 @@
 #include <ctime>
 
 #include "../../Utilities/BitUtilities.h"
+#include "../../Utilities/StateStream.h"
 
 void Rtc::Tick()
 {
@@ -19,10 +20,10 @@ void Rtc::Tick()
     
     const time_t currentTime = std::time(nullptr);
     std::tm localTime;
-#if ANDROID
-    localtime_r(&currentTime, &localTime);
-#else
+#ifdef _WIN32
     localtime_s(&localTime, &currentTime);
+#else
+    localtime_r(&currentTime, &localTime);
 #endif
 
     second = BitUtilities::BinaryEncodedDecimal(localTime.tm_sec);
@@ -56,3 +57,22 @@ void Rtc::Tick()
     
     lastTime = localTime;
 }
+
+void Rtc::SaveState(StateWriter& state) const
+{
+    // the clock registers follow the host clock, only what the interrupts are raised against is kept
+    state.Write(isInitialized);
+    state.Write<uint64_t>(quarterCount);
+    state.Write<int32_t>(lastTime.tm_sec);
+    state.Write<int32_t>(lastTime.tm_min);
+    state.Write<int32_t>(lastTime.tm_hour);
+}
+
+void Rtc::LoadState(StateReader& state)
+{
+    state.Read(isInitialized);
+    quarterCount = static_cast<size_t>(state.Read<uint64_t>());
+    lastTime.tm_sec = state.Read<int32_t>();
+    lastTime.tm_min = state.Read<int32_t>();
+    lastTime.tm_hour = state.Read<int32_t>();
+}
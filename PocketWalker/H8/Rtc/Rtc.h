@@ -1,4 +1,6 @@
 #pragma once
+#include <ctime>
+
 #include "../Board/Component.h"
 #include "../Memory/Memory.h"
 #include "../Cpu/Components/Interrupts.h"
@@ -8,17 +10,22 @@ class Interrupts;
 class Rtc : public Component
 {
 public:
-    Rtc(Memory* ram, Interrupts* interrupts) : ram(ram), interrupts(interrupts),
+    Rtc(Memory* ram, Interrupts* interrupts) :
         second(ram->CreateAccessor<uint8_t>(SECOND_ADDR)),
         minute(ram->CreateAccessor<uint8_t>(MINUTE_ADDR)),
+        day(ram->CreateAccessor<uint8_t>(DAY_ADDR)),
         hour(ram->CreateAccessor<uint8_t>(HOUR_ADDR)),
-        day(ram->CreateAccessor<uint8_t>(DAY_ADDR))
+        ram(ram),
+        interrupts(interrupts)
     {
         
     }
 
     void Tick() override;
 
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
     bool isInitialized;
     size_t quarterCount;
     std::tm lastTime;
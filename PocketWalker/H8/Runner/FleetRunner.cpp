@@ -0,0 +1,300 @@
+#include "FleetRunner.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "../H8300H.h"
+
+FleetRunner::FleetRunner(const size_t workerCount, const uint64_t sliceCycles) : sliceCycles(sliceCycles)
+{
+    if (workerCount == 0)
+        throw std::runtime_error("Fleet runner needs at least one worker.");
+
+    for (size_t index = 0; index < workerCount; index++)
+    {
+        workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+FleetRunner::~FleetRunner()
+{
+    Stop();
+}
+
+size_t FleetRunner::Add(H8300H* emulator)
+{
+    auto instance = std::make_unique<FleetInstance>();
+    instance->emulator = emulator;
+    instance->paceCycle = emulator->GetCycles();
+    instance->paceTime = std::chrono::steady_clock::now();
+
+    emulator->StartSliced();
+
+    FleetInstance* added = instance.get();
+    size_t index;
+    {
+        std::lock_guard lock(instancesMutex);
+        index = instances.size();
+        instances.push_back(std::move(instance));
+    }
+
+    activeCount++;
+    Push(nextWorker++ % workers.size(), added);
+
+    stateChanged.notify_all();
+    return index;
+}
+
+void FleetRunner::Start()
+{
+    if (isRunning)
+        return;
+
+    startTime = std::chrono::steady_clock::now();
+    {
+        std::lock_guard lock(instancesMutex);
+        for (const auto& instance : instances)
+        {
+            instance->paceCycle = instance->emulator->GetCycles();
+            instance->paceTime = startTime;
+        }
+    }
+
+    isRunning = true;
+    for (size_t index = 0; index < workers.size(); index++)
+    {
+        workers[index]->thread = std::thread(&FleetRunner::WorkerLoop, this, index);
+    }
+}
+
+void FleetRunner::Stop()
+{
+    {
+        std::lock_guard lock(stateMutex);
+        isRunning = false;
+    }
+    stateChanged.notify_all();
+
+    for (const auto& worker : workers)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+}
+
+void FleetRunner::Wait()
+{
+    std::unique_lock lock(stateMutex);
+    stateChanged.wait(lock, [this]
+    {
+        return activeCount == 0 || !isRunning;
+    });
+}
+
+size_t FleetRunner::GetInstanceCount() const
+{
+    std::lock_guard lock(instancesMutex);
+    return instances.size();
+}
+
+const FleetInstance& FleetRunner::GetInstance(const size_t index) const
+{
+    std::lock_guard lock(instancesMutex);
+    return *instances.at(index);
+}
+
+void FleetRunner::WorkerLoop(const size_t index)
+{
+    if (isCorePinning)
+    {
+        Pin(index);
+    }
+
+    auto lastUnpark = std::chrono::steady_clock::now();
+    while (isRunning)
+    {
+        // parked instances are looked at every so often even when every worker is busy, so a resumed one can't starve
+        const auto now = std::chrono::steady_clock::now();
+        if (parkedCount > 0 && now - lastUnpark >= PARK_INTERVAL)
+        {
+            Unpark(index);
+            lastUnpark = now;
+        }
+
+        FleetInstance* instance = Take(index);
+        if (instance == nullptr)
+        {
+            std::unique_lock lock(stateMutex);
+            stateChanged.wait_for(lock, PARK_INTERVAL);
+            continue;
+        }
+
+        if (IsParked(instance))
+        {
+            Park(instance);
+            continue;
+        }
+
+        if (RunSlice(instance, index))
+        {
+            Push(index, instance);
+        }
+        else
+        {
+            Finish(instance);
+        }
+    }
+}
+
+void FleetRunner::Pin(const size_t index) const
+{
+    const size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), 1ull << (index % cores));
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+FleetInstance* FleetRunner::Take(const size_t index)
+{
+    {
+        Worker& worker = *workers[index];
+        std::lock_guard lock(worker.mutex);
+        if (!worker.queue.empty())
+        {
+            FleetInstance* instance = worker.queue.front();
+            worker.queue.pop_front();
+            return instance;
+        }
+    }
+
+    // steal from the back, the instance that would have waited longest on its own worker
+    for (size_t offset = 1; offset < workers.size(); offset++)
+    {
+        Worker& victim = *workers[(index + offset) % workers.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.queue.empty())
+        {
+            FleetInstance* instance = victim.queue.back();
+            victim.queue.pop_back();
+            steals++;
+            return instance;
+        }
+    }
+
+    return nullptr;
+}
+
+void FleetRunner::Push(const size_t index, FleetInstance* instance)
+{
+    Worker& worker = *workers[index];
+    std::lock_guard lock(worker.mutex);
+    worker.queue.push_back(instance);
+}
+
+bool FleetRunner::RunSlice(FleetInstance* instance, const size_t worker)
+{
+    const auto begin = std::chrono::steady_clock::now();
+
+    bool isAlive;
+    try
+    {
+        isAlive = instance->emulator->RunSlice(sliceCycles);
+    }
+    catch (const std::exception& e)
+    {
+        // only reaches here with the emulator's own exception handling turned off
+        instance->error = e.what();
+        instance->emulator->Stop();
+        isAlive = false;
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    instance->busyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    instance->slices++;
+    instance->lastWorker = static_cast<uint32_t>(worker);
+
+    return isAlive;
+}
+
+bool FleetRunner::IsParked(const FleetInstance* instance) const
+{
+    if (instance->emulator->IsPaused())
+        return true;
+
+    if (!isPaced)
+        return false;
+
+    // ahead of real time, it gets picked back up once the clock catches up, a sleeping cpu counts as being at the
+    // cycle it can next wake on, so it waits there instead of running slices that skip through idle events,
+    // an interrupt raised by input brings that back to the current cycle
+    const uint64_t wakeCycle = instance->emulator->GetWakeCycle();
+    if (wakeCycle == UINT64_MAX)
+        return true;
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - instance->paceTime;
+    return wakeCycle - instance->paceCycle > elapsed.count() * Cpu::TICKS;
+}
+
+void FleetRunner::Park(FleetInstance* instance)
+{
+    instance->wasPaused = instance->emulator->IsPaused();
+
+    std::lock_guard lock(parkedMutex);
+    parked.push_back(instance);
+    parkedCount++;
+}
+
+void FleetRunner::Unpark(const size_t index)
+{
+    std::lock_guard lock(parkedMutex);
+    std::erase_if(parked, [this, index](FleetInstance* instance)
+    {
+        if (instance->wasPaused && !instance->emulator->IsPaused())
+        {
+            // time spent paused doesn't count towards pacing
+            instance->paceCycle = instance->emulator->GetCycles();
+            instance->paceTime = std::chrono::steady_clock::now();
+            instance->wasPaused = false;
+        }
+
+        if (!instance->emulator->IsRunning())
+        {
+            Finish(instance);
+            parkedCount--;
+            return true;
+        }
+
+        if (IsParked(instance))
+            return false;
+
+        Push(index, instance);
+        parkedCount--;
+        return true;
+    });
+}
+
+void FleetRunner::Finish(FleetInstance* instance)
+{
+    instance->isFinished = true;
+
+    {
+        std::lock_guard lock(stateMutex);
+        activeCount--;
+    }
+    stateChanged.notify_all();
+}
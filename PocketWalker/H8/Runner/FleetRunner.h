@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Cpu/Cpu.h"
+
+class H8300H;
+
+struct FleetInstance
+{
+    H8300H* emulator;
+
+    // accounting, busy time is wall time spent in this instance's slices on whichever worker ran them
+    std::atomic<uint64_t> slices = 0;
+    std::atomic<uint64_t> busyNanoseconds = 0;
+    std::atomic<uint32_t> lastWorker = 0;
+
+    std::atomic<bool> isFinished = false;
+    // only set before isFinished
+    std::string error;
+
+    // where pacing measures real time from, moved up when the instance comes back from a pause
+    uint64_t paceCycle = 0;
+    std::chrono::steady_clock::time_point paceTime;
+    bool wasPaused = false;
+};
+
+// runs many emulators on a fixed set of worker threads, each instance gets slices of a bounded cycle budget,
+// workers keep their own queue and steal from each other when it runs dry
+class FleetRunner
+{
+public:
+    FleetRunner(size_t workerCount, uint64_t sliceCycles = DEFAULT_SLICE_CYCLES);
+    ~FleetRunner();
+
+    // instances can be added before or while running, the runner doesn't own them
+    size_t Add(H8300H* emulator);
+
+    void Start();
+    void Stop();
+
+    // blocks until every instance has finished or the runner was stopped
+    void Wait();
+
+    // paced instances are held to real time and parked while they're ahead of it or asleep until a later cycle,
+    // unpaced ones always run since a sleeping cpu already skips straight to its wake cycle
+    void SetPaced(const bool value) { isPaced = value; }
+    void SetCorePinning(const bool value) { isCorePinning = value; }
+
+    size_t GetInstanceCount() const;
+    const FleetInstance& GetInstance(size_t index) const;
+    uint64_t GetSteals() const { return steals; }
+
+    // 10ms of emulated time
+    static constexpr uint64_t DEFAULT_SLICE_CYCLES = Cpu::TICKS / 100;
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<FleetInstance*> queue;
+        std::thread thread;
+    };
+
+    void WorkerLoop(size_t index);
+    void Pin(size_t index) const;
+
+    FleetInstance* Take(size_t index);
+    void Push(size_t index, FleetInstance* instance);
+
+    bool RunSlice(FleetInstance* instance, size_t worker);
+    bool IsParked(const FleetInstance* instance) const;
+    void Park(FleetInstance* instance);
+    void Unpark(size_t index);
+    void Finish(FleetInstance* instance);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    uint64_t sliceCycles;
+
+    mutable std::mutex instancesMutex;
+    std::vector<std::unique_ptr<FleetInstance>> instances;
+
+    std::mutex parkedMutex;
+    std::vector<FleetInstance*> parked;
+    std::atomic<size_t> parkedCount = 0;
+
+    // wakes idle workers when there's new work and Wait when the last instance finishes
+    std::mutex stateMutex;
+    std::condition_variable stateChanged;
+
+    std::atomic<size_t> activeCount = 0;
+    std::atomic<size_t> nextWorker = 0;
+    std::atomic<uint64_t> steals = 0;
+    std::atomic<bool> isRunning = false;
+
+    bool isPaced = false;
+    bool isCorePinning = false;
+    std::chrono::steady_clock::time_point startTime;
+
+    static constexpr auto PARK_INTERVAL = std::chrono::milliseconds(1);
+};
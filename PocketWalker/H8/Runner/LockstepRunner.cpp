@@ -0,0 +1,882 @@
+#include "LockstepRunner.h"
+
+#include <algorithm>
+#include <format>
+#include <print>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+#include "../H8300H.h"
+
+enum class LockstepKind : uint8_t
+{
+    Undecoded,
+    Unsupported,
+    Nop,
+    Mov,
+    Add,
+    Sub,
+    Cmp,
+    And,
+    Or,
+    Xor,
+    Inc,
+    Dec,
+    Adds,
+    Subs,
+    Load,
+    Store,
+    Branch
+};
+
+// runs one op over every slot, target is the destination register's row
+using LockstepKernel = void(*)(uint32_t* target, const uint32_t* operands, uint32_t* ccr, uint32_t shift);
+
+struct LockstepOp
+{
+    LockstepKind kind = LockstepKind::Undecoded;
+    LockstepKernel kernel = nullptr;
+    uint8_t size = 0;
+    uint8_t bytes = 0;
+    uint8_t cycles = 0;
+
+    // register index and where the sized view sits in it, the same views Registers hands out
+    uint8_t target = 0;
+    uint8_t targetShift = 0;
+    uint8_t source = 0;
+    uint8_t sourceShift = 0;
+    bool isImmediate = false;
+
+    uint8_t pointer = NO_POINTER;
+    uint8_t condition = 0;
+    uint32_t mask = 0;
+    // immediate, inc amount, absolute address, displacement or branch offset
+    uint32_t value = 0;
+
+    static constexpr uint8_t NO_POINTER = 0xFF;
+};
+
+namespace
+{
+    enum class Layout : uint8_t
+    {
+        None,
+        // Rs in bH, Rd in bL
+        Registers,
+        // #xx:8 in b with Rd in aL, #xx:16 and #xx:32 from c on with Rd in bL
+        Immediate8,
+        Immediate16,
+        Immediate32,
+        // Rd in bL, the amount is part of the instruction
+        Unary,
+        // pointer in bH and data register in bL, the long forms sit behind a 01 00 prefix and use dH/dL
+        Indirect,
+        IndirectLong,
+        Displacement,
+        DisplacementLong,
+        Absolute8,
+        Absolute16,
+        Absolute16Long,
+        Branch
+    };
+
+    struct OpShape
+    {
+        LockstepKind kind;
+        uint8_t size;
+        Layout layout;
+        uint8_t amount = 0;
+    };
+
+    // keyed on the names InstructionTable registers, so the two can't disagree about what an encoding does
+    const std::unordered_map<std::string_view, OpShape> SHAPES = {
+        {"NOP", {LockstepKind::Nop, 0, Layout::None}},
+
+        {"MOV.B Rs, Rd", {LockstepKind::Mov, 1, Layout::Registers}},
+        {"MOV.W Rs, Rd", {LockstepKind::Mov, 2, Layout::Registers}},
+        {"MOV.L ERs, ERd", {LockstepKind::Mov, 4, Layout::Registers}},
+        {"ADD.B Rs, Rd", {LockstepKind::Add, 1, Layout::Registers}},
+        {"ADD.W Rs, Rd", {LockstepKind::Add, 2, Layout::Registers}},
+        {"ADD.L ERs, ERd", {LockstepKind::Add, 4, Layout::Registers}},
+        {"SUB.B Rs, Rd", {LockstepKind::Sub, 1, Layout::Registers}},
+        {"SUB.W Rs, Rd", {LockstepKind::Sub, 2, Layout::Registers}},
+        {"SUB.L ERs, ERd", {LockstepKind::Sub, 4, Layout::Registers}},
+        {"CMP.B Rs, Rd", {LockstepKind::Cmp, 1, Layout::Registers}},
+        {"CMP.W Rs, Rd", {LockstepKind::Cmp, 2, Layout::Registers}},
+        {"CMP.L ERs, ERd", {LockstepKind::Cmp, 4, Layout::Registers}},
+        {"AND.B Rs, Rd", {LockstepKind::And, 1, Layout::Registers}},
+        {"AND.W Rs, Rd", {LockstepKind::And, 2, Layout::Registers}},
+        {"OR.B Rs, Rd", {LockstepKind::Or, 1, Layout::Registers}},
+        {"OR.W Rs, Rd", {LockstepKind::Or, 2, Layout::Registers}},
+        {"XOR.B Rs, Rd", {LockstepKind::Xor, 1, Layout::Registers}},
+        {"XOR.W Rs, Rd", {LockstepKind::Xor, 2, Layout::Registers}},
+
+        {"MOV.B #xx:8, Rd", {LockstepKind::Mov, 1, Layout::Immediate8}},
+        {"ADD.B #xx:8, Rd", {LockstepKind::Add, 1, Layout::Immediate8}},
+        {"CMP.B #xx:8, Rd", {LockstepKind::Cmp, 1, Layout::Immediate8}},
+        {"AND.B #xx:8, Rd", {LockstepKind::And, 1, Layout::Immediate8}},
+        {"OR.B #xx:8, Rd", {LockstepKind::Or, 1, Layout::Immediate8}},
+        {"XOR.B #xx:8, Rd", {LockstepKind::Xor, 1, Layout::Immediate8}},
+        {"MOV.W #xx:16, Rd", {LockstepKind::Mov, 2, Layout::Immediate16}},
+        {"ADD.W #xx:16, Rd", {LockstepKind::Add, 2, Layout::Immediate16}},
+        {"SUB.W #xx:16, Rd", {LockstepKind::Sub, 2, Layout::Immediate16}},
+        {"CMP.W #xx:16, Rd", {LockstepKind::Cmp, 2, Layout::Immediate16}},
+        {"AND.W #xx:16, Rd", {LockstepKind::And, 2, Layout::Immediate16}},
+        {"OR.W #xx:16, Rd", {LockstepKind::Or, 2, Layout::Immediate16}},
+        {"MOV.L #xx:32, ERd", {LockstepKind::Mov, 4, Layout::Immediate32}},
+        {"ADD.L #xx:32, ERd", {LockstepKind::Add, 4, Layout::Immediate32}},
+        {"CMP.L #xx:32, ERd", {LockstepKind::Cmp, 4, Layout::Immediate32}},
+        {"AND.L #xx:32, ERd", {LockstepKind::And, 4, Layout::Immediate32}},
+
+        {"INC.B Rd", {LockstepKind::Inc, 1, Layout::Unary, 1}},
+        {"INC.W #1, Rd", {LockstepKind::Inc, 2, Layout::Unary, 1}},
+        {"INC.W #2, Rd", {LockstepKind::Inc, 2, Layout::Unary, 2}},
+        {"INC.L #1, Rd", {LockstepKind::Inc, 4, Layout::Unary, 1}},
+        {"DEC.B ERd", {LockstepKind::Dec, 1, Layout::Unary, 1}},
+        {"DEC.W #1, Rd", {LockstepKind::Dec, 2, Layout::Unary, 1}},
+        {"ADDS #1, ERd", {LockstepKind::Adds, 4, Layout::Unary, 1}},
+        {"ADDS #2, ERd", {LockstepKind::Adds, 4, Layout::Unary, 2}},
+        {"ADDS #4, ERd", {LockstepKind::Adds, 4, Layout::Unary, 4}},
+        {"SUBS #2, ERd", {LockstepKind::Subs, 4, Layout::Unary, 2}},
+        {"SUBS #4, ERd", {LockstepKind::Subs, 4, Layout::Unary, 4}},
+
+        {"MOV.B @ERs, Rd", {LockstepKind::Load, 1, Layout::Indirect}},
+        {"MOV.W @ERs, Rd", {LockstepKind::Load, 2, Layout::Indirect}},
+        {"MOV.L @ERs, ERd", {LockstepKind::Load, 4, Layout::IndirectLong}},
+        {"MOV.B Rs, @ERd", {LockstepKind::Store, 1, Layout::Indirect}},
+        {"MOV.W Rs, @ERd", {LockstepKind::Store, 2, Layout::Indirect}},
+        {"MOV.L ERs, @ERd", {LockstepKind::Store, 4, Layout::IndirectLong}},
+        {"MOV.B @(d:16,ERs), Rd ", {LockstepKind::Load, 1, Layout::Displacement}},
+        {"MOV.W @(d:16,ERs), Rd ", {LockstepKind::Load, 2, Layout::Displacement}},
+        {"MOV.L @(d:16,ERs), ERd", {LockstepKind::Load, 4, Layout::DisplacementLong}},
+        {"MOV.B Rs, @(d:16,ERd)", {LockstepKind::Store, 1, Layout::Displacement}},
+        {"MOV.W Rs, @(d:16,ERd)", {LockstepKind::Store, 2, Layout::Displacement}},
+        {"MOV.L ERs, @(d:16,ERd)", {LockstepKind::Store, 4, Layout::DisplacementLong}},
+        {"MOV.B @aa:8, Rd", {LockstepKind::Load, 1, Layout::Absolute8}},
+        {"MOV.B Rs, @aa:8", {LockstepKind::Store, 1, Layout::Absolute8}},
+        {"MOV.B @aa:16, Rd", {LockstepKind::Load, 1, Layout::Absolute16}},
+        {"MOV.W @aa:16, Rd", {LockstepKind::Load, 2, Layout::Absolute16}},
+        {"MOV.L @aa:16, ERd", {LockstepKind::Load, 4, Layout::Absolute16Long}},
+        {"MOV.B Rs, @aa:16", {LockstepKind::Store, 1, Layout::Absolute16}},
+        {"MOV.W Rs, @aa:16", {LockstepKind::Store, 2, Layout::Absolute16}},
+        {"MOV.L ERs, @aa:16", {LockstepKind::Store, 4, Layout::Absolute16Long}},
+
+        {"BRA d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BHI d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BLS d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BCC d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BCS d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BNE d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BEQ d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BPL d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BMI d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BGE d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BLT d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BGT d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+        {"BLE d:8", {LockstepKind::Branch, 0, Layout::Branch}},
+    };
+
+    // ccr bits in the order of the Flags union
+    constexpr uint32_t CCR_CARRY = 1 << 0;
+    constexpr uint32_t CCR_OVERFLOW = 1 << 1;
+    constexpr uint32_t CCR_ZERO = 1 << 2;
+    constexpr uint32_t CCR_NEGATIVE = 1 << 3;
+    constexpr uint32_t CCR_HALF_CARRY = 1 << 5;
+
+    // the same results and flags as the templates in InstructionTable and Flags, quirks included, written without
+    // branches over a fixed trip count so the compiler turns each one into vector code
+    template<LockstepKind Kind, size_t Size>
+    void Execute(uint32_t* target, const uint32_t* operands, uint32_t* ccr, const uint32_t shift)
+    {
+        constexpr uint32_t bits = Size * 8;
+        constexpr uint32_t mask = Size == 4 ? UINT32_MAX : (1u << bits) - 1;
+        constexpr uint32_t negative = 1u << (bits - 1);
+        constexpr uint32_t halfCarry = bits / 2 - 1;
+
+        for (size_t slot = 0; slot < LockstepRunner::LANES; slot++)
+        {
+            const uint32_t rd = target[slot] >> shift & mask;
+            const uint32_t rs = operands[slot];
+
+            uint32_t result = 0;
+            uint32_t flags = 0;
+            uint32_t affected = 0;
+
+            if constexpr (Kind == LockstepKind::Mov || Kind == LockstepKind::Store || Kind == LockstepKind::And ||
+                Kind == LockstepKind::Or || Kind == LockstepKind::Xor)
+            {
+                if constexpr (Kind == LockstepKind::And)
+                    result = rd & rs;
+                else if constexpr (Kind == LockstepKind::Or)
+                    result = rd | rs;
+                else if constexpr (Kind == LockstepKind::Xor)
+                    result = rd ^ rs;
+                else
+                    result = rs;
+
+                flags = (result == 0) * CCR_ZERO | ((result & negative) != 0) * CCR_NEGATIVE;
+                affected = CCR_ZERO | CCR_NEGATIVE | CCR_OVERFLOW;
+            }
+            else if constexpr (Kind == LockstepKind::Add)
+            {
+                // zero comes from the sum before truncating, like Flags::ApplyAdd
+                result = rd + rs;
+                const bool carry = Size == 4 ? result < rd : result > mask;
+
+                flags = (result == 0) * CCR_ZERO | ((result & negative) != 0) * CCR_NEGATIVE |
+                    (((rd ^ rs) & (rd ^ result) & negative) != 0) * CCR_OVERFLOW | carry * CCR_CARRY |
+                    ((rd ^ rs ^ result) >> halfCarry & 1) * CCR_HALF_CARRY;
+                affected = CCR_ZERO | CCR_NEGATIVE | CCR_OVERFLOW | CCR_CARRY | CCR_HALF_CARRY;
+            }
+            else if constexpr (Kind == LockstepKind::Sub || Kind == LockstepKind::Cmp)
+            {
+                result = rd - rs;
+
+                flags = (result == 0) * CCR_ZERO | ((result & negative) != 0) * CCR_NEGATIVE |
+                    (((rd ^ rs) & (rd ^ result) & negative) != 0) * CCR_OVERFLOW | (rs > rd) * CCR_CARRY |
+                    ((rd ^ rs ^ result) >> halfCarry & 1) * CCR_HALF_CARRY;
+                affected = CCR_ZERO | CCR_NEGATIVE | CCR_OVERFLOW | CCR_CARRY | CCR_HALF_CARRY;
+            }
+            else if constexpr (Kind == LockstepKind::Inc)
+            {
+                result = rd + rs;
+
+                flags = (result == 0) * CCR_ZERO | ((result & negative) != 0) * CCR_NEGATIVE |
+                    (rd == (negative >> 1) - 1) * CCR_OVERFLOW;
+                affected = CCR_ZERO | CCR_NEGATIVE | CCR_OVERFLOW;
+            }
+            else if constexpr (Kind == LockstepKind::Dec)
+            {
+                result = rd - rs;
+
+                flags = (result == 0) * CCR_ZERO | ((result & negative) != 0) * CCR_NEGATIVE |
+                    (rd == negative) * CCR_OVERFLOW;
+                affected = CCR_ZERO | CCR_NEGATIVE | CCR_OVERFLOW;
+            }
+            else if constexpr (Kind == LockstepKind::Adds)
+            {
+                result = rd + rs;
+            }
+            else if constexpr (Kind == LockstepKind::Subs)
+            {
+                result = rd - rs;
+            }
+
+            ccr[slot] = (ccr[slot] & ~affected) | flags;
+
+            if constexpr (Kind != LockstepKind::Cmp && Kind != LockstepKind::Store)
+                target[slot] = (target[slot] & ~(mask << shift)) | (result & mask) << shift;
+        }
+    }
+
+    template<LockstepKind Kind>
+    LockstepKernel SizedKernel(const uint8_t size)
+    {
+        switch (size)
+        {
+        case 1:
+            return Execute<Kind, 1>;
+        case 2:
+            return Execute<Kind, 2>;
+        default:
+            return Execute<Kind, 4>;
+        }
+    }
+
+    LockstepKernel Kernel(const LockstepKind kind, const uint8_t size)
+    {
+        switch (kind)
+        {
+        case LockstepKind::Mov:
+        case LockstepKind::Load:
+            return SizedKernel<LockstepKind::Mov>(size);
+        case LockstepKind::Store:
+            return SizedKernel<LockstepKind::Store>(size);
+        case LockstepKind::Add:
+            return SizedKernel<LockstepKind::Add>(size);
+        case LockstepKind::Sub:
+            return SizedKernel<LockstepKind::Sub>(size);
+        case LockstepKind::Cmp:
+            return SizedKernel<LockstepKind::Cmp>(size);
+        case LockstepKind::And:
+            return SizedKernel<LockstepKind::And>(size);
+        case LockstepKind::Or:
+            return SizedKernel<LockstepKind::Or>(size);
+        case LockstepKind::Xor:
+            return SizedKernel<LockstepKind::Xor>(size);
+        case LockstepKind::Inc:
+            return SizedKernel<LockstepKind::Inc>(size);
+        case LockstepKind::Dec:
+            return SizedKernel<LockstepKind::Dec>(size);
+        case LockstepKind::Adds:
+            return SizedKernel<LockstepKind::Adds>(size);
+        case LockstepKind::Subs:
+            return SizedKernel<LockstepKind::Subs>(size);
+        default:
+            return nullptr;
+        }
+    }
+
+    // where the sized view of a register control nibble sits in its 32 bit register
+    void View(const uint8_t control, const uint8_t size, uint8_t& index, uint8_t& shift)
+    {
+        index = control & 0b111;
+
+        if (size == 1)
+            shift = control & 0b1000 ? 0 : 8;
+        else if (size == 2)
+            shift = control & 0b1000 ? 16 : 0;
+        else
+            shift = 0;
+    }
+
+    // Bcc condition in the low nibble of the first byte
+    bool IsTaken(const uint32_t ccr, const uint8_t condition)
+    {
+        const bool carry = ccr & CCR_CARRY;
+        const bool overflow = ccr & CCR_OVERFLOW;
+        const bool zero = ccr & CCR_ZERO;
+        const bool negative = ccr & CCR_NEGATIVE;
+
+        switch (condition)
+        {
+        case 0x0:
+            return true;
+        case 0x1:
+            return false;
+        case 0x2:
+            return !(carry || zero);
+        case 0x3:
+            return carry || zero;
+        case 0x4:
+            return !carry;
+        case 0x5:
+            return carry;
+        case 0x6:
+            return !zero;
+        case 0x7:
+            return zero;
+        case 0x8:
+            return !overflow;
+        case 0x9:
+            return overflow;
+        case 0xA:
+            return !negative;
+        case 0xB:
+            return negative;
+        case 0xC:
+            return negative == overflow;
+        case 0xD:
+            return negative != overflow;
+        case 0xE:
+            return !(zero || negative != overflow);
+        default:
+            return zero || negative != overflow;
+        }
+    }
+}
+
+LockstepRunner::LockstepRunner() : ops(std::make_unique<LockstepOp[]>(InstructionCache::CODE_END))
+{
+
+}
+
+LockstepRunner::~LockstepRunner() = default;
+
+void LockstepRunner::Add(H8300H* emulator)
+{
+    if (lanes.size() == LANES)
+        throw std::runtime_error(std::format("Lockstep runs at most {} lanes.", LANES));
+
+    Lane lane = {emulator, emulator->board->cpu};
+    Rehash(lane);
+
+    if (!lanes.empty() && lane.codeHash != lanes.front().codeHash)
+        throw std::runtime_error("Lockstep lanes have to run the same rom.");
+
+    emulator->StartSliced();
+    lanes.push_back(lane);
+}
+
+bool LockstepRunner::Run(const uint64_t cycles)
+{
+    for (Lane& lane : lanes)
+    {
+        const uint64_t now = lane.emulator->GetCycles();
+        const uint64_t end = cycles > UINT64_MAX - now ? UINT64_MAX : now + cycles;
+        lane.end = std::min(end, lane.emulator->cycleLimit);
+    }
+
+    while (true)
+    {
+        // the lane furthest behind goes first, ties go to the one furthest back in the code
+        Lane* leader = nullptr;
+        for (Lane& lane : lanes)
+        {
+            if (!IsActive(lane))
+                continue;
+
+            if (leader == nullptr || lane.emulator->GetCycles() < leader->emulator->GetCycles() ||
+                (lane.emulator->GetCycles() == leader->emulator->GetCycles() && lane.cpu->registers->pc < leader->cpu->registers->pc))
+            {
+                leader = &lane;
+            }
+        }
+
+        if (leader == nullptr)
+            break;
+
+        const uint16_t pc = leader->cpu->registers->pc;
+
+        groupSize = 0;
+        std::array<bool, LANES> isGrouped = {};
+        if (IsGroupable(*leader, pc))
+        {
+            for (size_t index = 0; index < lanes.size(); index++)
+            {
+                const Lane& lane = lanes[index];
+                if (IsActive(lane) && lane.cpu->registers->pc == pc && lane.codeHash == leader->codeHash && IsGroupable(lane, pc))
+                {
+                    group[groupSize++] = index;
+                    isGrouped[index] = true;
+                }
+            }
+        }
+
+        uint64_t nextCycles = UINT64_MAX;
+        for (size_t index = 0; index < lanes.size(); index++)
+        {
+            const Lane& lane = lanes[index];
+            if (&lane == leader || isGrouped[index] || !IsActive(lane))
+                continue;
+
+            SetWaiting(lane.cpu->registers->pc, true);
+            nextCycles = std::min(nextCycles, lane.emulator->GetCycles());
+        }
+
+        if (groupSize >= 2)
+        {
+            if (RunGroup(pc) == 0)
+            {
+                StepLane(*leader);
+            }
+        }
+        else
+        {
+            // nothing to share, the leader runs by itself until it passes the others or reaches one of them
+            do
+            {
+                StepLane(*leader);
+            } while (IsActive(*leader) && leader->emulator->GetCycles() <= nextCycles && !IsWaiting(leader->cpu->registers->pc));
+        }
+
+        for (const Lane& lane : lanes)
+        {
+            SetWaiting(lane.cpu->registers->pc, false);
+        }
+    }
+
+    bool isRunning = false;
+    for (const Lane& lane : lanes)
+    {
+        H8300H* emulator = lane.emulator;
+
+        // without the accumulator thread packets go out between runs
+        emulator->board->sci3->FlushPacket();
+
+        if (emulator->GetCycles() >= emulator->cycleLimit)
+        {
+            emulator->Stop();
+        }
+
+        isRunning |= emulator->IsRunning();
+    }
+
+    return isRunning;
+}
+
+bool LockstepRunner::IsActive(const Lane& lane) const
+{
+    return lane.emulator->IsRunning() && !lane.emulator->IsPaused() && lane.emulator->GetCycles() < lane.end;
+}
+
+bool LockstepRunner::IsGroupable(const Lane& lane, const uint16_t pc) const
+{
+    const Cpu* cpu = lane.cpu;
+
+    // sleeps, interrupts and hooks all need the scalar path, and the idle loop detector has to see every step
+    if (cpu->sleeping || (cpu->interrupts->pending && !cpu->flags->interrupt) || lane.emulator->idleLoopSkipping)
+        return false;
+
+    return pc != 0x0000 && pc < InstructionCache::CODE_END && !cpu->HasAddressHandler(pc);
+}
+
+void LockstepRunner::StepLane(Lane& lane)
+{
+    H8300H* emulator = lane.emulator;
+    if (emulator->isExceptionHandling)
+    {
+        try
+        {
+            emulator->Step();
+        }
+        catch (const std::exception& e)
+        {
+            std::println("\033[31m{}\033[0m", e.what());
+            emulator->Stop();
+        }
+    }
+    else
+    {
+        emulator->Step();
+    }
+
+    stats.scalarSteps++;
+
+    if (lane.cpu->instructionCache->generation != lane.generation)
+    {
+        Rehash(lane);
+    }
+}
+
+void LockstepRunner::Rehash(Lane& lane) const
+{
+    lane.generation = lane.cpu->instructionCache->generation;
+    lane.codeHash = RecompiledBackend::Hash(lane.cpu->ram->buffer, InstructionCache::CODE_END);
+}
+
+size_t LockstepRunner::RunGroup(uint16_t pc)
+{
+    const Lane& first = lanes[group[0]];
+    if (first.codeHash != opsHash)
+    {
+        std::fill_n(ops.get(), InstructionCache::CODE_END, LockstepOp());
+        opsHash = first.codeHash;
+    }
+
+    Cpu* decoder = first.cpu;
+    for (size_t slot = 0; slot < groupSize; slot++)
+    {
+        const Lane& lane = lanes[group[slot]];
+        const Scheduler* scheduler = lane.emulator->board->scheduler;
+
+        // nothing fires inside a segment, the op that reaches a lane's next deadline is left to a scalar step
+        deadlineRooms[slot] = scheduler->nextDeadline > scheduler->cycles ? scheduler->nextDeadline - scheduler->cycles : 0;
+        endRooms[slot] = lane.end - scheduler->cycles;
+
+        lane.cpu->flags->Resolve();
+        ccr[slot] = lane.cpu->flags->ccr;
+        for (uint8_t index = 0; index < 8; index++)
+        {
+            registers[index][slot] = *lane.cpu->registers->Register32(index);
+        }
+    }
+
+    uint64_t deadlineRoom = *std::min_element(deadlineRooms.begin(), deadlineRooms.begin() + groupSize);
+    uint64_t endRoom = *std::min_element(endRooms.begin(), endRooms.begin() + groupSize);
+
+    uint64_t run = 0;
+    size_t executed = 0;
+    bool isDiverged = false;
+    while (groupSize >= 2 && pc != 0x0000 && pc < InstructionCache::CODE_END && (executed == 0 || !IsWaiting(pc)) && !IsHooked(pc))
+    {
+        const LockstepOp& op = Decode(pc, decoder);
+        if (op.kind == LockstepKind::Unsupported)
+            break;
+
+        if (run + op.cycles >= deadlineRoom || run >= endRoom)
+        {
+            // lanes without room for this op drop out where they are, the rest carry on without them
+            for (size_t slot = 0; slot < groupSize;)
+            {
+                if (run + op.cycles >= deadlineRooms[slot] || run >= endRooms[slot])
+                {
+                    Retire(slot, pc, run, executed);
+                    SetWaiting(pc, true);
+                }
+                else
+                {
+                    slot++;
+                }
+            }
+
+            if (groupSize == 0)
+                break;
+
+            deadlineRoom = *std::min_element(deadlineRooms.begin(), deadlineRooms.begin() + groupSize);
+            endRoom = *std::min_element(endRooms.begin(), endRooms.begin() + groupSize);
+            continue;
+        }
+
+        if (op.kind == LockstepKind::Load)
+        {
+            if (!Load(op))
+                break;
+        }
+        else if (op.kind == LockstepKind::Store)
+        {
+            if (!Store(op))
+                break;
+        }
+        else if (op.kernel != nullptr)
+        {
+            if (op.isImmediate)
+            {
+                std::fill_n(operands, LANES, op.value);
+            }
+            else
+            {
+                for (size_t slot = 0; slot < LANES; slot++)
+                {
+                    operands[slot] = registers[op.source][slot] >> op.sourceShift & op.mask;
+                }
+            }
+
+            op.kernel(registers[op.target], operands, ccr, op.targetShift);
+        }
+
+        run += op.cycles;
+        executed++;
+
+        if (op.kind == LockstepKind::Branch)
+        {
+            if (!Branch(op, pc))
+            {
+                isDiverged = true;
+                break;
+            }
+        }
+        else
+        {
+            pc += op.bytes;
+        }
+    }
+
+    if (executed > 0)
+    {
+        stats.segments++;
+        stats.divergences += isDiverged;
+    }
+
+    while (groupSize > 0)
+    {
+        Retire(0, isDiverged ? pcs[0] : pc, run, executed);
+    }
+
+    return executed;
+}
+
+void LockstepRunner::Retire(const size_t slot, const uint16_t pc, const uint64_t run, const size_t executed)
+{
+    const Lane& lane = lanes[group[slot]];
+    Cpu* cpu = lane.cpu;
+
+    if (executed > 0)
+    {
+        cpu->registers->pc = pc;
+        cpu->flags->ccr = static_cast<uint8_t>(ccr[slot]);
+        for (uint8_t index = 0; index < 8; index++)
+        {
+            *cpu->registers->Register32(index) = registers[index][slot];
+        }
+
+        cpu->instructionCount += executed;
+        lane.emulator->board->scheduler->Advance(run);
+        stats.lockstepInstructions += executed;
+    }
+
+    // the last slot moves into the gap so the group stays packed
+    const size_t last = --groupSize;
+    group[slot] = group[last];
+    ccr[slot] = ccr[last];
+    pcs[slot] = pcs[last];
+    deadlineRooms[slot] = deadlineRooms[last];
+    endRooms[slot] = endRooms[last];
+    for (uint8_t index = 0; index < 8; index++)
+    {
+        registers[index][slot] = registers[index][last];
+    }
+}
+
+const LockstepOp& LockstepRunner::Decode(const uint16_t pc, Cpu* cpu)
+{
+    LockstepOp& op = ops[pc];
+    if (op.kind != LockstepKind::Undecoded)
+        return op;
+
+    op.kind = LockstepKind::Unsupported;
+
+    const CachedInstruction* cached = cpu->instructionCache->Fetch(pc, cpu->opcodes);
+    if (cached->instruction == nullptr)
+        return op;
+
+    const auto shape = SHAPES.find(cached->instruction->name);
+    if (shape == SHAPES.end())
+        return op;
+
+    const uint8_t* opcode = cached->opcode;
+    const OpShape& info = shape->second;
+
+    op.size = info.size;
+    op.bytes = cached->bytes;
+    op.cycles = cached->cycles;
+    op.kernel = Kernel(info.kind, info.size);
+    op.mask = info.size == 4 ? UINT32_MAX : (1u << info.size * 8) - 1;
+
+    switch (info.layout)
+    {
+    case Layout::Registers:
+        View(opcode[1] >> 4, info.size, op.source, op.sourceShift);
+        View(opcode[1] & 0xF, info.size, op.target, op.targetShift);
+        break;
+    case Layout::Immediate8:
+        View(opcode[0] & 0xF, info.size, op.target, op.targetShift);
+        op.isImmediate = true;
+        op.value = opcode[1];
+        break;
+    case Layout::Immediate16:
+        View(opcode[1] & 0xF, info.size, op.target, op.targetShift);
+        op.isImmediate = true;
+        op.value = opcode[2] << 8 | opcode[3];
+        break;
+    case Layout::Immediate32:
+        View(opcode[1] & 0xF, info.size, op.target, op.targetShift);
+        op.isImmediate = true;
+        op.value = static_cast<uint32_t>(opcode[2]) << 24 | opcode[3] << 16 | opcode[4] << 8 | opcode[5];
+        break;
+    case Layout::Unary:
+        View(opcode[1] & 0xF, info.size, op.target, op.targetShift);
+        op.isImmediate = true;
+        op.value = info.amount;
+        break;
+    case Layout::Indirect:
+        op.pointer = opcode[1] >> 4 & 0b111;
+        View(opcode[1] & 0xF, info.size, op.target, op.targetShift);
+        break;
+    case Layout::IndirectLong:
+        op.pointer = opcode[3] >> 4 & 0b111;
+        View(opcode[3] & 0xF, info.size, op.target, op.targetShift);
+        break;
+    case Layout::Displacement:
+        op.pointer = opcode[1] >> 4 & 0b111;
+        View(opcode[1] & 0xF, info.size, op.target, op.targetShift);
+        op.value = static_cast<int16_t>(opcode[2] << 8 | opcode[3]);
+        break;
+    case Layout::DisplacementLong:
+        op.pointer = opcode[3] >> 4 & 0b111;
+        View(opcode[3] & 0xF, info.size, op.target, op.targetShift);
+        op.value = static_cast<int16_t>(opcode[4] << 8 | opcode[5]);
+        break;
+    case Layout::Absolute8:
+        View(opcode[0] & 0xF, info.size, op.target, op.targetShift);
+        op.value = opcode[1] | 0xFF00;
+        break;
+    case Layout::Absolute16:
+        View(opcode[1] & 0xF, info.size, op.target, op.targetShift);
+        op.value = opcode[2] << 8 | opcode[3];
+        break;
+    case Layout::Absolute16Long:
+        View(opcode[3] & 0xF, info.size, op.target, op.targetShift);
+        op.value = opcode[4] << 8 | opcode[5];
+        break;
+    case Layout::Branch:
+        op.condition = opcode[0] & 0xF;
+        op.value = static_cast<int8_t>(opcode[1]);
+        break;
+    default:
+        break;
+    }
+
+    op.kind = info.kind;
+    return op;
+}
+
+bool LockstepRunner::IsHooked(const uint16_t pc) const
+{
+    for (size_t slot = 0; slot < groupSize; slot++)
+    {
+        if (lanes[group[slot]].cpu->HasAddressHandler(pc))
+            return true;
+    }
+
+    return false;
+}
+
+bool LockstepRunner::Load(const LockstepOp& op)
+{
+    // every lane has to land on plain memory or none of them run it, handlers and watches need the scalar path
+    std::array<uint16_t, LANES> addresses;
+    for (size_t slot = 0; slot < groupSize; slot++)
+    {
+        const uint32_t base = op.pointer == LockstepOp::NO_POINTER ? 0 : registers[op.pointer][slot];
+        addresses[slot] = static_cast<uint16_t>(base + op.value);
+
+        if (!lanes[group[slot]].cpu->ram->IsPlain(addresses[slot], op.size))
+            return false;
+    }
+
+    for (size_t slot = 0; slot < groupSize; slot++)
+    {
+        const uint8_t* buffer = lanes[group[slot]].cpu->ram->buffer + addresses[slot];
+
+        uint32_t value = 0;
+        for (size_t index = 0; index < op.size; index++)
+        {
+            value = value << 8 | buffer[index];
+        }
+
+        operands[slot] = value;
+    }
+
+    op.kernel(registers[op.target], operands, ccr, op.targetShift);
+    return true;
+}
+
+bool LockstepRunner::Store(const LockstepOp& op)
+{
+    std::array<uint16_t, LANES> addresses;
+    for (size_t slot = 0; slot < groupSize; slot++)
+    {
+        const uint32_t base = op.pointer == LockstepOp::NO_POINTER ? 0 : registers[op.pointer][slot];
+        addresses[slot] = static_cast<uint16_t>(base + op.value);
+
+        if (!lanes[group[slot]].cpu->ram->IsPlain(addresses[slot], op.size))
+            return false;
+    }
+
+    for (size_t slot = 0; slot < LANES; slot++)
+    {
+        operands[slot] = registers[op.target][slot] >> op.targetShift & op.mask;
+    }
+
+    for (size_t slot = 0; slot < groupSize; slot++)
+    {
+        uint8_t* buffer = lanes[group[slot]].cpu->ram->buffer + addresses[slot];
+        for (size_t index = 0; index < op.size; index++)
+        {
+            buffer[index] = operands[slot] >> (op.size - 1 - index) * 8 & 0xFF;
+        }
+    }
+
+    op.kernel(registers[op.target], operands, ccr, op.targetShift);
+    return true;
+}
+
+bool LockstepRunner::Branch(const LockstepOp& op, uint16_t& pc)
+{
+    size_t taken = 0;
+    for (size_t slot = 0; slot < groupSize; slot++)
+    {
+        const bool isTaken = IsTaken(ccr[slot], op.condition);
+        pcs[slot] = pc + op.bytes + (isTaken ? op.value : 0);
+        taken += isTaken;
+    }
+
+    // the group only goes on while every lane went the same way
+    if (taken != 0 && taken != groupSize)
+        return false;
+
+    pc = pcs[0];
+    return true;
+}
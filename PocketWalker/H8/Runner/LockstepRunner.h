@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class H8300H;
+class Cpu;
+struct LockstepOp;
+
+struct LockstepStats
+{
+    // instructions each lane ran inside a shared segment, a segment over 8 lanes of 10 instructions counts 80
+    uint64_t lockstepInstructions = 0;
+    uint64_t scalarSteps = 0;
+    uint64_t segments = 0;
+    // segments that ended on a branch the lanes didn't agree on
+    uint64_t divergences = 0;
+};
+
+// runs emulators of the same rom together, lanes sitting on the same pc run the shared instruction stream over
+// registers kept as structure of arrays, anything the shared path can't do exactly splits them back into single steps
+class LockstepRunner
+{
+public:
+    LockstepRunner();
+    ~LockstepRunner();
+
+    // the runner doesn't own the emulators, every lane has to start from the same rom
+    void Add(H8300H* emulator);
+
+    // runs every lane by at least the given cycles, false once every lane has stopped
+    bool Run(uint64_t cycles);
+
+    size_t GetLaneCount() const { return lanes.size(); }
+    const LockstepStats& GetStats() const { return stats; }
+
+    static constexpr size_t LANES = 16;
+
+private:
+    struct Lane
+    {
+        H8300H* emulator;
+        Cpu* cpu;
+        uint64_t end = 0;
+
+        // code can be rewritten by a scalar step, lanes only share a segment while their code hashes agree
+        uint32_t generation = 0;
+        uint32_t codeHash = 0;
+    };
+
+    bool IsActive(const Lane& lane) const;
+    bool IsGroupable(const Lane& lane, uint16_t pc) const;
+    void StepLane(Lane& lane);
+    void Rehash(Lane& lane) const;
+
+    size_t RunGroup(uint16_t pc);
+    void Retire(size_t slot, uint16_t pc, uint64_t run, size_t executed);
+    const LockstepOp& Decode(uint16_t pc, Cpu* cpu);
+    bool IsHooked(uint16_t pc) const;
+
+    void SetWaiting(const uint16_t pc, const bool value)
+    {
+        if (value)
+            waiting[pc >> 6] |= 1ull << (pc & 0x3F);
+        else
+            waiting[pc >> 6] &= ~(1ull << (pc & 0x3F));
+    }
+
+    bool IsWaiting(const uint16_t pc) const
+    {
+        return waiting[pc >> 6] >> (pc & 0x3F) & 1;
+    }
+
+    bool Load(const LockstepOp& op);
+    bool Store(const LockstepOp& op);
+    bool Branch(const LockstepOp& op, uint16_t& pc);
+
+    std::vector<Lane> lanes;
+    LockstepStats stats;
+
+    // decoded ops for the rom region, only valid for code matching opsHash
+    std::unique_ptr<LockstepOp[]> ops;
+    uint32_t opsHash = 0;
+
+    // lanes of the running group, slot n of the arrays below belongs to group[n]
+    std::array<size_t, LANES> group = {};
+    size_t groupSize = 0;
+
+    // pcs of the lanes outside the group, reaching one ends the segment so they can join up
+    std::array<uint64_t, 0x10000 / 64> waiting = {};
+
+    // cycles each slot can run before its next event or the end of the run
+    std::array<uint64_t, LANES> deadlineRooms = {};
+    std::array<uint64_t, LANES> endRooms = {};
+
+    alignas(64) uint32_t registers[8][LANES] = {};
+    alignas(64) uint32_t ccr[LANES] = {};
+    alignas(64) uint32_t operands[LANES] = {};
+    std::array<uint16_t, LANES> pcs = {};
+};
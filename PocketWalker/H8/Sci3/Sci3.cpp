@@ -1,7 +1,12 @@
 #include "Sci3.h"
 
+#include "../../Utilities/StateStream.h"
+
 void Sci3::StartPacketAccumulator()
-{ 
+{
+    if (senderRunning)
+        return;
+
     senderRunning = true;
     packetSenderThread = std::thread([&]
     {
@@ -9,23 +14,7 @@ void Sci3::StartPacketAccumulator()
         {
             std::this_thread::sleep_for(std::chrono::milliseconds(2));
 
-            if (!hasTransmitData) continue;
-            if (transmitBuffer.empty()) continue;
-                
-            std::unique_lock lock(transmitMutex);
-                
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTransmitTime);
-                
-            if (elapsed.count() >= packetTimeout)
-            {
-               OnTransmitPacket(transmitBuffer);
-                    
-               transmitBuffer.clear();
-               hasTransmitData = false;
-            }
-                
-            lock.unlock();
+            FlushPacket();
         }
     });
 }
@@ -33,7 +22,30 @@ void Sci3::StartPacketAccumulator()
 void Sci3::StopPacketAccumulator()
 {
     senderRunning = false;
-    packetSenderThread.join();
+
+    if (packetSenderThread.joinable())
+    {
+        packetSenderThread.join();
+    }
+}
+
+void Sci3::FlushPacket()
+{
+    if (!hasTransmitData) return;
+
+    std::unique_lock lock(transmitMutex);
+    if (transmitBuffer.empty()) return;
+
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTransmitTime);
+
+    if (elapsed.count() >= packetTimeout)
+    {
+       OnTransmitPacket(transmitBuffer);
+
+       transmitBuffer.clear();
+       hasTransmitData = false;
+    }
 }
 
 void Sci3::Tick()
@@ -76,6 +88,59 @@ void Sci3::Tick()
     }
 }
 
+bool Sci3::IsIdle()
+{
+    if (~status & Sci3Flags::STATUS_TRANSMIT_EMPTY)
+        return false;
+    
+    if (control & Sci3Flags::CONTROL_RECEIVE_ENABLE && ~status & Sci3Flags::STATUS_RECEIVE_FULL)
+    {
+        std::lock_guard lock(receiveMutex);
+        return receiveBuffer.empty();
+    }
+
+    return true;
+}
+
+void Sci3::SaveState(StateWriter& state) const
+{
+    {
+        std::lock_guard lock(receiveMutex);
+
+        std::queue<uint8_t> pending = receiveBuffer;
+        state.Write<uint32_t>(static_cast<uint32_t>(pending.size()));
+        for (; !pending.empty(); pending.pop())
+        {
+            state.Write(pending.front());
+        }
+    }
+
+    std::lock_guard lock(transmitMutex);
+    state.Write<uint32_t>(static_cast<uint32_t>(transmitBuffer.size()));
+    state.WriteBytes(transmitBuffer.data(), transmitBuffer.size());
+}
+
+void Sci3::LoadState(StateReader& state)
+{
+    {
+        std::lock_guard lock(receiveMutex);
+
+        receiveBuffer = {};
+        for (uint32_t count = state.Read<uint32_t>(); count > 0; count--)
+        {
+            receiveBuffer.push(state.Read<uint8_t>());
+        }
+    }
+
+    std::lock_guard lock(transmitMutex);
+    transmitBuffer.resize(state.Read<uint32_t>());
+    state.ReadBytes(transmitBuffer.data(), transmitBuffer.size());
+
+    // a half sent packet goes out after the usual timeout from now
+    lastTransmitTime = std::chrono::steady_clock::now();
+    hasTransmitData = !transmitBuffer.empty();
+}
+
 void Sci3::Receive(const uint8_t byte)
 {
     std::lock_guard lock(receiveMutex);
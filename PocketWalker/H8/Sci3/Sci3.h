@@ -36,11 +36,12 @@ namespace Sci3Flags
 class Sci3 : public Component
 {
 public:
-    Sci3(Memory* ram) : ram(ram),
+    Sci3(Memory* ram) :
         control(ram->CreateAccessor<uint8_t>(CONTROL_ADDR)),
         status(ram->CreateAccessor<uint8_t>(STATUS_ADDR)),
         transmit(ram->CreateAccessor<uint8_t>(TRANSMIT_ADDR)),
-        receive(ram->CreateAccessor<uint8_t>(RECEIVE_ADDR))
+        receive(ram->CreateAccessor<uint8_t>(RECEIVE_ADDR)),
+        ram(ram)
     {
         ram->OnRead(RECEIVE_ADDR, [this](uint8_t, bool)
         {
@@ -54,8 +55,6 @@ public:
         });
 
         ram->AddReadOnlyAddress(STATUS_ADDR);
-        
-        StartPacketAccumulator();
     }
 
     ~Sci3() override
@@ -64,12 +63,19 @@ public:
     }
 
     void Tick() override;
+    bool IsIdle();
+
+    // bytes still waiting to be received or sent out in a packet go with the state
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
 
     void Receive(uint8_t byte);
 
     
+    // the accumulator thread flushes packets on its own, without it whoever runs the emulator calls FlushPacket
     void StartPacketAccumulator();
     void StopPacketAccumulator();
+    void FlushPacket();
 
     void SetPacketTimeout(const int timeout)
     {
@@ -95,10 +101,10 @@ private:
     static constexpr uint16_t STATUS_ADDR = 0xFF9C;
     static constexpr uint16_t RECEIVE_ADDR = 0xFF9D;
 
-    std::mutex receiveMutex;
+    mutable std::mutex receiveMutex;
     
     std::vector<uint8_t> transmitBuffer;
-    std::mutex transmitMutex;
+    mutable std::mutex transmitMutex;
     std::chrono::steady_clock::time_point lastTransmitTime;
     std::atomic<bool> hasTransmitData{false};
     int packetTimeout = 5;
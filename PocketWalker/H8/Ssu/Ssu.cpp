@@ -1,16 +1,17 @@
 #include "Ssu.h"
 
-#include <ranges>
+#include <algorithm>
 #include <stdexcept>
 
 #include "../IO/IOComponent.h"
+#include "../../Utilities/StateStream.h"
 
 void Ssu::Tick()
 {
     // not changing for checks, use "cached" value
     auto enableFlag = this->enable.Get();
     auto statusFlag = this->status.Get();
-    
+
     if (~enableFlag & SsuFlags::Enable::TRANSMIT_ENABLE && ~statusFlag & SsuFlags::Status::TRANSMIT_EMPTY)
     {
         this->status |= SsuFlags::Status::TRANSMIT_EMPTY;
@@ -42,13 +43,43 @@ void Ssu::Tick()
     }
 }
 
+void Ssu::SaveState(StateWriter& state) const
+{
+    state.Write<uint64_t>(clockRate);
+    state.Write(progress);
+    state.Write(baseCycle);
+    state.Write(isProgressing);
+}
+
+void Ssu::LoadState(StateReader& state)
+{
+    // the transfer event's deadline comes back with the scheduler
+    clockRate = static_cast<size_t>(state.Read<uint64_t>());
+    state.Read(progress);
+    state.Read(baseCycle);
+    state.Read(isProgressing);
+}
+
+void Ssu::Refresh()
+{
+    Sync();
+    Reschedule();
+}
+
 void Ssu::RegisterIOPeripheral(Port port, uint8_t pin, IOComponent* component)
 {
-    if (!peripherals.contains(port)) {
-        peripherals[port] = std::map<uint8_t, IOComponent*>();
+    const auto position = std::ranges::find_if(peripherals, [port, pin](const Peripheral& peripheral)
+    {
+        return peripheral.port > port || (peripheral.port == port && peripheral.pin >= pin);
+    });
+
+    if (position != peripherals.end() && position->port == port && position->pin == pin)
+    {
+        position->component = component;
+        return;
     }
-    
-    peripherals[port][pin] = component;
+
+    peripherals.insert(position, {port, pin, component, ram->CreateAccessor<uint8_t>(port)});
 }
 
 uint8_t Ssu::GetPort(uint16_t address)
@@ -56,41 +87,104 @@ uint8_t Ssu::GetPort(uint16_t address)
     return ram->ReadByte(address);
 }
 
-void Ssu::ExecutePeripherals(const std::function<void(IOComponent* peripheral)>& executeFunction,
-                             bool invertPortSelect, bool isTick)
+bool Ssu::IsSelected(const Peripheral& peripheral)
 {
-    for (const auto& port : peripherals | std::views::keys)
-    {
-        ExecutePeripherals(port, executeFunction, invertPortSelect, isTick);
-    }
+    return peripheral.component->IsSerial() && peripheral.IsActive() && peripheral.component->CanExecute(this);
 }
 
-void Ssu::ExecutePeripherals(const Port port, const std::function<void(IOComponent* peripheral)>& executeFunction,
-    bool invertPortSelect, bool isTick)
+void Ssu::ExecutePeripherals(const std::function<void(IOComponent* peripheral)>& executeFunction)
 {
-    for (const auto& pins = peripherals[port]; auto [pin, peripheral] : pins)
+    for (const Peripheral& peripheral : peripherals)
     {
-        const uint8_t currentPortValue = GetPort(port);
-            
-        uint8_t comparePortValue = peripheral->IsData() ? currentPortValue : ~currentPortValue;
-        if (invertPortSelect) comparePortValue = ~comparePortValue;
-            
-        if (comparePortValue & pin && peripheral->CanExecute(this))
+        if (!IsSelected(peripheral))
+            continue;
+
+        if (peripheral.component->IsProgressive())
         {
-            if (peripheral->IsProgressive() && isTick)
-            {
-                progress++;
+            progress++;
 
-                if (progress == 7)
-                {
-                    progress = 0;
-                    executeFunction(peripheral);
-                }
-            }
-            else
+            if (progress == PROGRESS_CLOCKS)
             {
-                executeFunction(peripheral);
+                progress = 0;
+                executeFunction(peripheral.component);
             }
         }
+        else
+        {
+            executeFunction(peripheral.component);
+        }
+    }
+}
+
+void Ssu::SelectPeripherals(const Port port)
+{
+    // deselecting a peripheral ends whatever it was in the middle of
+    for (const Peripheral& peripheral : peripherals)
+    {
+        if (peripheral.port == port && !peripheral.IsActive() && peripheral.component->CanExecute(this))
+        {
+            peripheral.component->Reset();
+        }
     }
+
+    Refresh();
+}
+
+void Ssu::SyncTo(const uint64_t cycle)
+{
+    if (isProgressing)
+    {
+        progress += static_cast<uint8_t>(cycle / clockRate - baseCycle / clockRate);
+    }
+
+    baseCycle = cycle;
+}
+
+void Ssu::Reschedule()
+{
+    const uint8_t enableFlag = enable.Get();
+    const uint8_t statusFlag = status.Get();
+    const uint64_t nextClock = (baseCycle / clockRate + 1) * clockRate;
+
+    isProgressing = false;
+
+    // receive only always ends up throwing on the next clock
+    if (~enableFlag & SsuFlags::Enable::TRANSMIT_ENABLE)
+    {
+        const bool isPending = enableFlag & SsuFlags::Enable::RECEIVE_ENABLE || ~statusFlag & SsuFlags::Status::TRANSMIT_EMPTY;
+        scheduler->SetDeadline(transferEvent, isPending ? nextClock : UINT64_MAX);
+        return;
+    }
+
+    if (statusFlag & SsuFlags::Status::TRANSMIT_EMPTY)
+    {
+        scheduler->SetDeadline(transferEvent, UINT64_MAX);
+        return;
+    }
+
+    bool isProgressive = false;
+    for (const Peripheral& peripheral : peripherals)
+    {
+        if (!IsSelected(peripheral))
+            continue;
+
+        if (!peripheral.component->IsProgressive())
+        {
+            scheduler->SetDeadline(transferEvent, nextClock);
+            return;
+        }
+
+        isProgressive = true;
+    }
+
+    if (!isProgressive)
+    {
+        // nothing selected to take the byte, it waits on a port write
+        scheduler->SetDeadline(transferEvent, UINT64_MAX);
+        return;
+    }
+
+    // the byte lands on the clock that brings progress up to PROGRESS_CLOCKS
+    isProgressing = true;
+    scheduler->SetDeadline(transferEvent, nextClock + (PROGRESS_CLOCKS - 1 - progress) * clockRate);
 }
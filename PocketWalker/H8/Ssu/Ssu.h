@@ -1,9 +1,10 @@
 #pragma once
 #include <array>
-#include <map>
+#include <vector>
 #include <print>
 
 #include "../Board/Component.h"
+#include "../Board/Scheduler.h"
 #include "../Cpu/Components/Interrupts.h"
 #include "../Memory/Memory.h"
 #include "../Memory/MemoryAccessor.h"
@@ -74,7 +75,7 @@ public:
         PIN_5 = 1 << 5,
     };
     
-    Ssu(Memory* ram, Interrupts* interrupts, Flags* flags) : ram(ram), interrupts(interrupts), flags(flags),
+    Ssu(Memory* ram, Interrupts* interrupts, Flags* flags, Scheduler* scheduler) :
         mode(ram->CreateAccessor<uint8_t>(MODE_ADDR)),
         enable(ram->CreateAccessor<uint8_t>(ENABLE_ADDR)),
         status(ram->CreateAccessor<uint8_t>(STATUS_ADDR)),
@@ -84,7 +85,11 @@ public:
         port3(ram->CreateAccessor<uint8_t>(PORT_3)),
         port8(ram->CreateAccessor<uint8_t>(PORT_8)),
         port9(ram->CreateAccessor<uint8_t>(PORT_9)),
-        portB(ram->CreateAccessor<uint8_t>(PORT_B))
+        portB(ram->CreateAccessor<uint8_t>(PORT_B)),
+        ram(ram),
+        flags(flags),
+        interrupts(interrupts),
+        scheduler(scheduler)
     {
         ram->OnRead(RECEIVE_ADDR, [this](uint32_t, bool)
         {
@@ -95,29 +100,45 @@ public:
         {
             status &= ~SsuFlags::Status::TRANSMIT_EMPTY;
             status &= ~SsuFlags::Status::TRANSMIT_END;
+
+            Refresh();
         });
 
         ram->OnWrite(MODE_ADDR, [this](uint32_t mode, bool)
         {
+            Sync();
             clockRate = clockRates[mode & 0b111];
+
+            Refresh();
         });
         
-        ram->OnWrite(PORT_1, [this](uint32_t, bool)
+        ram->OnWrite(ENABLE_ADDR, [this](uint32_t, bool)
         {
-            ExecutePeripherals(PORT_1, [](IOComponent* peripheral)
-            {
-                peripheral->Reset();
-            }, true, false);
+            Refresh();
         });
         
-        ram->OnWrite(PORT_9, [this](uint32_t, bool)
+        ram->OnWrite(STATUS_ADDR, [this](uint32_t, bool)
         {
-            ExecutePeripherals(PORT_9, [](IOComponent* peripheral)
-            {
-                peripheral->Reset();
-            }, true, false);
+            Refresh();
         });
         
+        for (const Port port : {PORT_1, PORT_9})
+        {
+            ram->OnWrite(port, [this, port](uint32_t, bool)
+            {
+                SelectPeripherals(port);
+            });
+        }
+        
+        // only selects and deselects here, whatever is on these ports keeps its state
+        for (const Port port : {PORT_3, PORT_8})
+        {
+            ram->OnWrite(port, [this](uint32_t, bool)
+            {
+                Refresh();
+            });
+        }
+        
         ram->OnWrite(PORT_B, [this](uint32_t port, bool)
         {
             if (port & SsuFlags::PortB::IRQ0)
@@ -127,17 +148,44 @@ public:
                     this->interrupts->flag1 |= InterruptFlags::Flag1::FLAG_IRQ0;
                 }
             }
+
+            Refresh();
+        });
+
+        // one shot, only armed while a transfer is waiting on a peripheral
+        transferEvent = scheduler->Schedule(0, [this]
+        {
+            const uint64_t cycle = this->scheduler->cycles;
+            
+            SyncTo(cycle - 1);
+            Tick();
+            baseCycle = cycle;
+            
+            Reschedule();
         });
+
+        // registers start out cleared, the first clock raises transmit empty
+        Refresh();
     }
 
+    // runs one ssu clock of the transfer in progress
     void Tick() override;
 
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+    // settles the clocks so far, then schedules the clock the transfer next does something on
+    void Refresh();
+
     void RegisterIOPeripheral(Port port, uint8_t pin, IOComponent* component);
 
     uint8_t GetPort(uint16_t address);
 
     size_t clockRate = 4;
-    uint8_t progress;
+    uint8_t progress = 0;
+
+    // clocks a progressive peripheral takes per byte
+    static constexpr uint8_t PROGRESS_CLOCKS = 7;
     
     MemoryAccessor<uint8_t> mode;
     MemoryAccessor<uint8_t> enable;
@@ -152,12 +200,43 @@ public:
     MemoryAccessor<uint8_t> portB;
 
 private:
-    void ExecutePeripherals(const std::function<void(IOComponent* peripheral)>& executeFunction, bool invertPortSelect = false, bool isTick = true);
-    void ExecutePeripherals(Port port, const std::function<void(IOComponent* peripheral)>& executeFunction, bool invertPortSelect = false, bool isTick = true);
+    struct Peripheral
+    {
+        Port port;
+        uint8_t pin;
+        IOComponent* component;
+        MemoryAccessor<uint8_t> portValue;
+
+        bool IsActive() const
+        {
+            // chip selects are active low, data pins active high
+            const uint8_t value = component->IsData() ? portValue.Get() : ~portValue.Get();
+            return value & pin;
+        }
+    };
+
+    void Sync()
+    {
+        SyncTo(scheduler->cycles);
+    }
+    
+    void SyncTo(uint64_t cycle);
+    void Reschedule();
+    void SelectPeripherals(Port port);
+    bool IsSelected(const Peripheral& peripheral);
+    void ExecutePeripherals(const std::function<void(IOComponent* peripheral)>& executeFunction);
     
     Memory* ram;
     Flags* flags;
     Interrupts* interrupts;
+    Scheduler* scheduler;
+
+    size_t transferEvent;
+    uint64_t baseCycle = 0;
+    
+    // the only selected peripheral is progressive, clocks until then only count its progress
+    bool isProgressing = false;
 
-    std::map<Port, std::map<uint8_t, IOComponent*>> peripherals;
+    // ordered by port then pin, transfers go through these in order
+    std::vector<Peripheral> peripherals;
 };
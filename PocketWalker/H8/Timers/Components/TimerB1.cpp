@@ -1,6 +1,7 @@
 #include "TimerB1.h"
 
 #include "../../Cpu/Components/Interrupts.h"
+#include "../../../Utilities/StateStream.h"
 
 void TimerB1::Tick()
 {
@@ -14,3 +15,15 @@ void TimerB1::Tick()
         counter += 1;
     }
 }
+
+void TimerB1::SaveState(StateWriter& state) const
+{
+    TimerChannel::SaveState(state);
+    state.Write(loadValue);
+}
+
+void TimerB1::LoadState(StateReader& state)
+{
+    TimerChannel::LoadState(state);
+    state.Read(loadValue);
+}
@@ -1,7 +1,8 @@
 #pragma once
 #include <array>
+#include <limits>
 
-#include "../../Board/Component.h"
+#include "TimerChannel.h"
 #include "../../Memory/Memory.h"
 #include "../../Memory/MemoryAccessor.h"
 
@@ -16,34 +17,67 @@ namespace TimerB1Flags
     };
 }
 
-class TimerB1 : public Component
+class TimerB1 : public TimerChannel
 {
 public:
-    TimerB1(Memory* ram, Interrupts* interrupts) : ram(ram), interrupts(interrupts),
+    TimerB1(Memory* ram, Interrupts* interrupts, Scheduler* scheduler, const MemoryAccessor<uint8_t>& clockStop, const uint8_t standby) :
+        TimerChannel(scheduler, clockStop, standby, 256),
         mode(ram->CreateAccessor<uint8_t>(MODE_ADDR)),
-        counter(ram->CreateAccessor<uint8_t>(COUNTER_ADDR))
+        counter(ram->CreateAccessor<uint8_t>(COUNTER_ADDR)),
+        ram(ram),
+        interrupts(interrupts)
     {
         ram->OnWrite(MODE_ADDR, [this](uint32_t mode, bool)
         {
-            clockRate = clockRates[mode & 0b111];
+            SetClockRate(clockRates[mode & 0b111]);
         });
         
         ram->OnWrite(COUNTER_ADDR, [this](uint32_t value, bool isHardware)
         {
             if (!isHardware)
+            {
                 loadValue = value;
+                Rebase();
+            }
+        });
+
+        ram->OnRead(COUNTER_ADDR, [this](uint32_t, bool)
+        {
+            Sync();
         });
     }
 
     void Tick() override;
 
-    size_t clockRate = 256;
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
     uint8_t loadValue = 0;
-    bool isCounting = false;
 
     MemoryAccessor<uint8_t> mode;
     MemoryAccessor<uint8_t> counter;
 
+protected:
+    bool IsEnabled() const override
+    {
+        return mode & TimerB1Flags::MODE_COUNTING;
+    }
+
+    uint32_t GetCounter() const override
+    {
+        return counter;
+    }
+
+    void SetCounter(const uint32_t value) override
+    {
+        counter = static_cast<uint8_t>(value);
+    }
+
+    uint32_t CountsUntilTick() const override
+    {
+        return std::numeric_limits<uint8_t>::max() - counter;
+    }
+
 private:
     Memory* ram;
     Interrupts* interrupts;
@@ -0,0 +1,67 @@
+#include "TimerChannel.h"
+
+#include "../../../Utilities/StateStream.h"
+
+void TimerChannel::Refresh()
+{
+    Sync();
+
+    // a rate of 0 is a prescaler setting that isn't emulated
+    isCounting = clockStop & standby && IsEnabled() && clockRate != 0;
+    
+    Reschedule();
+}
+
+void TimerChannel::SetClockRate(const size_t rate)
+{
+    Sync();
+    clockRate = rate;
+    
+    Refresh();
+}
+
+void TimerChannel::Rebase()
+{
+    baseCycle = scheduler->cycles;
+    
+    Reschedule();
+}
+
+void TimerChannel::SaveState(StateWriter& state) const
+{
+    state.Write<uint64_t>(clockRate);
+    state.Write(isCounting);
+    state.Write(baseCycle);
+}
+
+void TimerChannel::LoadState(StateReader& state)
+{
+    // the count event's deadline comes back with the scheduler
+    clockRate = static_cast<size_t>(state.Read<uint64_t>());
+    state.Read(isCounting);
+    state.Read(baseCycle);
+}
+
+void TimerChannel::SyncTo(const uint64_t cycle)
+{
+    if (isCounting)
+    {
+        // counts land on every multiple of the period
+        const uint64_t period = TICK_CYCLES * clockRate;
+        SetCounter(GetCounter() + static_cast<uint32_t>(cycle / period - baseCycle / period));
+    }
+
+    baseCycle = cycle;
+}
+
+void TimerChannel::Reschedule()
+{
+    if (!isCounting)
+    {
+        scheduler->SetDeadline(countEvent, UINT64_MAX);
+        return;
+    }
+
+    const uint64_t period = TICK_CYCLES * clockRate;
+    scheduler->SetDeadline(countEvent, (baseCycle / period + 1 + CountsUntilTick()) * period);
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+
+#include "../../Board/Component.h"
+#include "../../Board/Scheduler.h"
+#include "../../Cpu/Cpu.h"
+#include "../../Memory/Memory.h"
+#include "../../Memory/MemoryAccessor.h"
+
+// a counter that is only brought up to date when it is read, the next count that does more than
+// increment (overflow, compare match) is scheduled as a single event that runs Tick for that count
+class TimerChannel : public Component
+{
+public:
+    TimerChannel(Scheduler* scheduler, const MemoryAccessor<uint8_t>& clockStop, const uint8_t standby, const size_t clockRate) :
+        clockRate(clockRate), scheduler(scheduler), clockStop(clockStop), standby(standby)
+    {
+        countEvent = scheduler->Schedule(0, [this]
+        {
+            const uint64_t cycle = this->scheduler->cycles;
+            
+            SyncTo(cycle - 1);
+            Tick();
+            baseCycle = cycle;
+            
+            Reschedule();
+        });
+    }
+
+    // brings the counter register up to the current cycle
+    void Sync()
+    {
+        SyncTo(scheduler->cycles);
+    }
+    
+    // counting settings changed, settle the count so far with the old ones first
+    void Refresh();
+    void SetClockRate(size_t rate);
+    
+    // software wrote the counter register, count on from that value
+    void Rebase();
+
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+    size_t clockRate;
+    bool isCounting = false;
+    
+    static constexpr size_t TICKS = 32768;
+    static constexpr size_t TICK_CYCLES = Cpu::TICKS / TICKS;
+
+protected:
+    virtual bool IsEnabled() const = 0;
+
+    virtual uint32_t GetCounter() const = 0;
+    virtual void SetCounter(uint32_t value) = 0;
+
+    // plain increments left before the one Tick has to handle
+    virtual uint32_t CountsUntilTick() const = 0;
+    
+private:
+    void SyncTo(uint64_t cycle);
+    void Reschedule();
+    
+    Scheduler* scheduler;
+    MemoryAccessor<uint8_t> clockStop;
+    uint8_t standby;
+    
+    uint64_t baseCycle = 0;
+    size_t countEvent;
+};
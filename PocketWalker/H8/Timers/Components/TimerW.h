@@ -1,8 +1,10 @@
 #pragma once
 #include <array>
 #include <cstdint>
+#include <algorithm>
+#include <limits>
 
-#include "../../Board/Component.h"
+#include "TimerChannel.h"
 #include "../../Memory/Memory.h"
 #include "../../Memory/MemoryAccessor.h"
 
@@ -22,28 +24,55 @@ namespace TimerWFlags
     };
 }
 
-class TimerW : public Component
+class TimerW : public TimerChannel
 {
 public:
-    TimerW(Memory* ram, Interrupts* interrupts) : ram(ram), interrupts(interrupts),
+    TimerW(Memory* ram, Interrupts* interrupts, Scheduler* scheduler, const MemoryAccessor<uint8_t>& clockStop, const uint8_t standby) :
+        TimerChannel(scheduler, clockStop, standby, 16),
         mode(ram->CreateAccessor<uint8_t>(MODE_ADDR)),
         control(ram->CreateAccessor<uint8_t>(CONTROL_ADDR)),
         counter(ram->CreateAccessor<uint16_t>(COUNTER_ADDR)),
         registerA(ram->CreateAccessor<uint16_t>(REGISTER_A_ADDR)),
         registerB(ram->CreateAccessor<uint16_t>(REGISTER_B_ADDR)),
         registerC(ram->CreateAccessor<uint16_t>(REGISTER_C_ADDR)),
-        registerD(ram->CreateAccessor<uint16_t>(REGISTER_D_ADDR))
+        registerD(ram->CreateAccessor<uint16_t>(REGISTER_D_ADDR)),
+        ram(ram),
+        interrupts(interrupts)
     {
         ram->OnWrite(CONTROL_ADDR, [this](uint32_t control, bool)
         {
-            clockRate = clockRates[(control >> 4) & 0b111];
+            SetClockRate(clockRates[(control >> 4) & 0b111]);
         });
+
+        ram->OnWrite(MODE_ADDR, [this](uint32_t, bool)
+        {
+            Refresh();
+        });
+
+        // the compare match moves with register a
+        for (const uint16_t address : {REGISTER_A_ADDR, static_cast<uint16_t>(REGISTER_A_ADDR + 1)})
+        {
+            ram->OnWrite(address, [this](uint32_t, bool)
+            {
+                Refresh();
+            });
+        }
+
+        for (const uint16_t address : {COUNTER_ADDR, static_cast<uint16_t>(COUNTER_ADDR + 1)})
+        {
+            ram->OnWrite(address, [this](uint32_t, bool)
+            {
+                Rebase();
+            });
+            
+            ram->OnRead(address, [this](uint32_t, bool)
+            {
+                Sync();
+            });
+        }
     }
 
     void Tick() override;
-    
-    size_t clockRate = 16;
-    bool isCounting;
 
     MemoryAccessor<uint8_t> mode;
     MemoryAccessor<uint8_t> control;
@@ -53,6 +82,32 @@ public:
     MemoryAccessor<uint16_t> registerB;
     MemoryAccessor<uint16_t> registerC;
     MemoryAccessor<uint16_t> registerD;
+
+protected:
+    bool IsEnabled() const override
+    {
+        return mode & TimerWFlags::MODE_COUNTING;
+    }
+
+    uint32_t GetCounter() const override
+    {
+        return counter;
+    }
+
+    void SetCounter(const uint32_t value) override
+    {
+        counter = static_cast<uint16_t>(value);
+    }
+
+    uint32_t CountsUntilTick() const override
+    {
+        // the count that wraps, or the first one that lands on or past register a
+        const uint32_t value = counter;
+        const uint32_t untilOverflow = std::numeric_limits<uint16_t>::max() - value;
+        const uint32_t untilCompare = value + 1 >= registerA ? 0 : registerA - 1 - value;
+        
+        return std::min(untilOverflow, untilCompare);
+    }
     
 private:
     Memory* ram;
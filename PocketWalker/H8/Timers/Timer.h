@@ -1,5 +1,6 @@
 #pragma once
 #include "../Board/Component.h"
+#include "../Board/Scheduler.h"
 #include "../Memory/Memory.h"
 #include "Components/TimerB1.h"
 #include "Components/TimerW.h"
@@ -26,21 +27,34 @@ namespace TimerFlags
     
 }
 
+// b1 and w count lazily and schedule their own overflow and compare events, so there's nothing to tick here
 class Timer : public Component
 {
 public:
-    Timer(Memory* ram, Interrupts* interrupts) : ram(ram), interrupts(interrupts),
-        b1(new TimerB1(ram, interrupts)),
-        w(new TimerW(ram, interrupts)),
+    Timer(Memory* ram, Interrupts* interrupts, Scheduler* scheduler) :
+        b1(new TimerB1(ram, interrupts, scheduler, ram->CreateAccessor<uint8_t>(CLOCK_STOP_1_ADDR), TimerFlags::STANDBY_TIMER_B1)),
+        w(new TimerW(ram, interrupts, scheduler, ram->CreateAccessor<uint8_t>(CLOCK_STOP_2_ADDR), TimerFlags::STANDBY_TIMER_W)),
         clockStop1(ram->CreateAccessor<uint8_t>(CLOCK_STOP_1_ADDR)),
-        clockStop2(ram->CreateAccessor<uint8_t>(CLOCK_STOP_2_ADDR))
+        clockStop2(ram->CreateAccessor<uint8_t>(CLOCK_STOP_2_ADDR)),
+        ram(ram),
+        interrupts(interrupts)
     {
+        ram->OnWrite(CLOCK_STOP_1_ADDR, [this](uint32_t, bool)
+        {
+            b1->Refresh();
+        });
         
+        ram->OnWrite(CLOCK_STOP_2_ADDR, [this](uint32_t, bool)
+        {
+            w->Refresh();
+        });
     }
 
-    void Tick() override;
-
-    size_t clockCycles;
+    ~Timer() override
+    {
+        delete b1;
+        delete w;
+    }
 
     TimerB1* b1;
     TimerW* w;
@@ -48,8 +62,6 @@ public:
     MemoryAccessor<uint8_t> clockStop1;
     MemoryAccessor<uint8_t> clockStop2;
 
-    static constexpr size_t TICKS = 32768;
-
 private:
     Memory* ram;
     Interrupts* interrupts;
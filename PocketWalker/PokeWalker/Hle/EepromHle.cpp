@@ -0,0 +1,113 @@
+#include "EepromHle.h"
+
+#include <cstring>
+
+#include "../../H8/Cpu/Recompiled/RecompiledBackend.h"
+#include "../../H8/Memory/Memory.h"
+#include "../../H8/Ssu/Ssu.h"
+#include "../IO/Eeprom/Eeprom.h"
+
+bool EepromHle::Attach(const EepromRoutines& routines)
+{
+    // the routines are addresses into one specific rom, anything else would jump into the middle of unrelated code
+    if (RecompiledBackend::Hash(cpu->ram->buffer, InstructionCache::CODE_END) != routines.hash)
+        return false;
+
+    const std::array<uint8_t, 4> arguments = {routines.addressRegister, routines.bufferRegister, routines.lengthRegister, 0};
+
+    if (routines.readAddress != 0)
+    {
+        hle->Register({"eeprom read", routines.readAddress, {}, arguments, 0, 0, routines.cyclesPerByte,
+            [this](Cpu*, const HleRoutine& routine)
+            {
+                return Read(routine);
+            }});
+    }
+
+    if (routines.writeAddress != 0)
+    {
+        hle->Register({"eeprom write", routines.writeAddress, {}, arguments, 0, 0, routines.cyclesPerByte,
+            [this](Cpu*, const HleRoutine& routine)
+            {
+                return Write(routine);
+            }});
+    }
+
+    isAttached = true;
+    return true;
+}
+
+size_t EepromHle::Read(const HleRoutine& routine) const
+{
+    const uint16_t address = routine.Argument(cpu, 0);
+    const uint16_t buffer = routine.Argument(cpu, 1);
+    const uint16_t length = routine.Argument(cpu, 2);
+
+    if (!IsRamBuffer(buffer, length))
+        return HLE_FALLBACK;
+
+    uint8_t* source = eeprom->memory->buffer;
+    uint8_t* destination = cpu->ram->buffer + buffer;
+    if (address + length <= 0x10000)
+    {
+        std::memcpy(destination, source + address, length);
+    }
+    else
+    {
+        // addresses wrap the same way the byte at a time reads do
+        for (uint16_t index = 0; index < length; index++)
+        {
+            destination[index] = source[static_cast<uint16_t>(address + index)];
+        }
+    }
+
+    return Finish(length);
+}
+
+size_t EepromHle::Write(const HleRoutine& routine) const
+{
+    const uint16_t address = routine.Argument(cpu, 0);
+    const uint16_t buffer = routine.Argument(cpu, 1);
+    const uint16_t length = routine.Argument(cpu, 2);
+
+    if (!IsRamBuffer(buffer, length))
+        return HLE_FALLBACK;
+
+    const uint8_t* source = cpu->ram->buffer + buffer;
+    uint8_t* destination = eeprom->memory->buffer;
+    if (length <= PAGE_SIZE && address + length <= 0x10000)
+    {
+        std::memcpy(destination + address, source, length);
+    }
+    else
+    {
+        // past a page the offset wraps back onto the start of the write
+        for (uint16_t index = 0; index < length; index++)
+        {
+            destination[static_cast<uint16_t>(address + index % PAGE_SIZE)] = source[index];
+        }
+    }
+
+    // the rom enables writes ahead of every block
+    eeprom->status |= EepromFlags::Status::WRITE_UNLOCK;
+
+    return Finish(length);
+}
+
+bool EepromHle::IsRamBuffer(const uint16_t buffer, const uint16_t length) const
+{
+    // watches have to see every byte, the rom routine does that
+    return buffer >= RAM_START && buffer + length <= RAM_END && !cpu->ram->IsWatched(buffer, length);
+}
+
+size_t EepromHle::Finish(const size_t length) const
+{
+    // chip select goes back up at the end of a transfer
+    eeprom->Reset();
+
+    // every byte waits out the eeprom's ssu clocks, the routine's own overhead is charged per unit
+    const size_t bytes = HEADER_BYTES + length;
+    cpu->handlerCycles += bytes * Ssu::PROGRESS_CLOCKS * ssu->clockRate;
+
+    return bytes;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+
+#include "../../H8/Hle/HleRegistry.h"
+
+class Eeprom;
+class Ssu;
+
+// where a rom keeps its eeprom block transfer subroutines, only valid for the rom it was taken from
+struct EepromRoutines
+{
+    uint32_t hash;
+
+    // entry points, 0 leaves that direction to the rom
+    uint16_t readAddress;
+    uint16_t writeAddress;
+
+    // 16 bit register controls holding the eeprom address, ram buffer and length on entry
+    uint8_t addressRegister;
+    uint8_t bufferRegister;
+    uint8_t lengthRegister;
+
+    // cycles the routine spends around each byte on top of the ssu transfer itself
+    size_t cyclesPerByte;
+};
+
+// runs the rom's eeprom block transfers natively instead of one ssu byte at a time
+class EepromHle
+{
+public:
+    EepromHle(Cpu* cpu, HleRegistry* hle, Ssu* ssu, Eeprom* eeprom) : cpu(cpu), hle(hle), ssu(ssu), eeprom(eeprom)
+    {
+
+    }
+
+    bool Attach(const EepromRoutines& routines);
+
+    bool IsAttached() const { return isAttached; }
+
+    // the ram the rom buffers transfers in, anything outside it goes through the rom routine
+    static constexpr uint16_t RAM_START = 0xF780;
+    static constexpr uint32_t RAM_END = 0xFF80;
+
+    // command and address bytes sent ahead of the data
+    static constexpr size_t HEADER_BYTES = 3;
+
+    // eeprom writes wrap within a page
+    static constexpr size_t PAGE_SIZE = 128;
+
+private:
+    size_t Read(const HleRoutine& routine) const;
+    size_t Write(const HleRoutine& routine) const;
+
+    bool IsRamBuffer(uint16_t buffer, uint16_t length) const;
+    size_t Finish(size_t length) const;
+
+    Cpu* cpu;
+    HleRegistry* hle;
+    Ssu* ssu;
+    Eeprom* eeprom;
+
+    bool isAttached = false;
+};
@@ -1,6 +1,7 @@
 #include "Accelerometer.h"
 
 #include "../../../H8/Ssu/Ssu.h"
+#include "../../../Utilities/StateStream.h"
 
 void Accelerometer::TransmitAndReceive(Ssu* ssu)
 {
@@ -63,3 +64,19 @@ void Accelerometer::Reset()
     state = GettingAddress;
     offset = 0;
 }
+
+void Accelerometer::SaveState(StateWriter& state) const
+{
+    state.Write<uint8_t>(this->state);
+    state.Write(address);
+    state.Write(offset);
+    state.WriteBytes(memory->buffer, MEMORY_SIZE);
+}
+
+void Accelerometer::LoadState(StateReader& state)
+{
+    this->state = static_cast<AccelerometerState>(state.Read<uint8_t>());
+    state.Read(address);
+    state.Read(offset);
+    state.ReadBytes(memory->buffer, MEMORY_SIZE);
+}
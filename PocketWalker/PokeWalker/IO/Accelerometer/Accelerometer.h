@@ -15,17 +15,27 @@ public:
     
     Accelerometer()
     {
-        memory = new Memory(0x7F);
+        memory = new Memory(MEMORY_SIZE);
+    }
+
+    ~Accelerometer() override
+    {
+        delete memory;
     }
     
     void TransmitAndReceive(Ssu* ssu) override;
     void Transmit(Ssu* ssu) override;
     void Reset() override;
 
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
     AccelerometerState state;
     uint16_t address;
     uint16_t offset;
     
 //private:
     Memory* memory;
+
+    static constexpr size_t MEMORY_SIZE = 0x7F;
 };
@@ -22,9 +22,18 @@ public:
 
     void Tick() override;
 
+    // silent and already reported as silent, ticking would only repeat that
+    bool IsIdle() const { return !timerW->isCounting && !isPlaying; }
+
+    bool IsSerial() override
+    {
+        return false;
+    }
+
     EventHandler<AudioInformation> OnPlayAudio;
 
     static constexpr size_t TICKS = 256;
 private:
     TimerW* timerW;
+    bool isPlaying = false;
 };
@@ -4,10 +4,10 @@
 
 void Buttons::Press(const Button button)
 {
-    portB |= button;
+    ram->WriteByte(Ssu::PORT_B, ram->ReadByte(Ssu::PORT_B, true) | button, true);
 }
 
 void Buttons::Release(const Button button)
 {
-    portB &= ~button;
+    ram->WriteByte(Ssu::PORT_B, ram->ReadByte(Ssu::PORT_B, true) & ~button, true);
 }
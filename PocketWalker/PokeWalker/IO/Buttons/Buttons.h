@@ -1,6 +1,6 @@
 #pragma once
 #include "../../../H8/IO/IOComponent.h"
-#include "../../../H8/Memory/MemoryAccessor.h"
+#include "../../../H8/Memory/Memory.h"
 
 class Buttons : public IOComponent
 {
@@ -12,14 +12,20 @@ public:
         Right = 1 << 4
     };
     
-    Buttons(MemoryAccessor<uint8_t> portB) : portB(portB)
+    Buttons(Memory* ram) : ram(ram)
     {
         
     }
 
     void Press(Button button);
     void Release(Button button);
+
+    bool IsSerial() override
+    {
+        return false;
+    }
     
 private:
-    MemoryAccessor<uint8_t> portB;
+    // the port goes through memory so the ssu sees the edge and raises irq0
+    Memory* ram;
 };
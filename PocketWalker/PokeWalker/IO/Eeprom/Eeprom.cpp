@@ -1,6 +1,8 @@
 #include "Eeprom.h"
 
 #include "../../../H8/Ssu/Ssu.h"
+#include "../../../Utilities/StateStream.h"
+
 void Eeprom::TransmitAndReceive(Ssu* ssu)
 {
     switch (state)
@@ -97,3 +99,23 @@ void Eeprom::Reset()
     state = Waiting;
     offset = 0;
 }
+
+void Eeprom::SaveState(StateWriter& state) const
+{
+    state.Write<uint8_t>(this->state);
+    state.Write(status);
+    state.Write(highAddress);
+    state.Write(lowAddress);
+    state.Write(offset);
+    state.WriteBytes(memory->buffer, SIZE);
+}
+
+void Eeprom::LoadState(StateReader& state)
+{
+    this->state = static_cast<EepromState>(state.Read<uint8_t>());
+    state.Read(status);
+    state.Read(highAddress);
+    state.Read(lowAddress);
+    state.Read(offset);
+    state.ReadChangedBytes(memory->buffer, SIZE);
+}
@@ -37,11 +37,20 @@ public:
     {
         memory = new Memory(eeprom_buffer);
     }
+
+    // the buffer stays with whoever handed it in
+    ~Eeprom() override
+    {
+        delete memory;
+    }
     
     void TransmitAndReceive(Ssu* ssu) override;
     void Transmit(Ssu* ssu) override;
     void Reset() override;
 
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
     bool IsProgressive() override
     {
         return true;
@@ -54,4 +63,6 @@ public:
     uint16_t offset;
     
     Memory* memory;
+
+    static constexpr size_t SIZE = 0x10000;
 };
@@ -3,6 +3,7 @@
 #include <print>
 
 #include "../../../H8/Ssu/Ssu.h"
+#include "../../../Utilities/StateStream.h"
 
 void Lcd::Transmit(Ssu* ssu)
 {
@@ -11,6 +12,7 @@ void Lcd::Transmit(Ssu* ssu)
     {
         const uint16_t address = (page * TOTAL_COLUMNS * COLUMN_SIZE) + (column * COLUMN_SIZE) + offset;
         memory->WriteByte(address, ssu->transmit);
+        isDirty |= !powerSaveMode;
 
         if (offset == 1)
         {
@@ -27,6 +29,8 @@ void Lcd::Transmit(Ssu* ssu)
     {
 
         const uint8_t command = ssu->transmit;
+        isDirty = true;
+        
         switch (state) {
         case Waiting:
             {
@@ -135,6 +139,32 @@ void Lcd::Tick()
     }
 
     OnDraw(LcdInformation(buffer, contrast - 20));
+    isDirty = false;
+}
+
+void Lcd::SaveState(StateWriter& state) const
+{
+    state.Write(this->state);
+    state.Write<uint64_t>(column);
+    state.Write<uint64_t>(offset);
+    state.Write<uint64_t>(page);
+    state.Write(contrast);
+    state.Write(pageOffset);
+    state.Write(powerSaveMode);
+    state.WriteBytes(memory->buffer, MEMORY_SIZE);
+}
+
+void Lcd::LoadState(StateReader& state)
+{
+    state.Read(this->state);
+    column = static_cast<size_t>(state.Read<uint64_t>());
+    offset = static_cast<size_t>(state.Read<uint64_t>());
+    page = static_cast<size_t>(state.Read<uint64_t>());
+    state.Read(contrast);
+    state.Read(pageOffset);
+    state.Read(powerSaveMode);
+    state.ReadBytes(memory->buffer, MEMORY_SIZE);
+    isDirty = true;
 }
 
 bool Lcd::IsDataMode(Ssu* ssu)
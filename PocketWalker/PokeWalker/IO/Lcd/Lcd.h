@@ -18,12 +18,23 @@ class Lcd : public IOComponent
 public:
     Lcd()
     {
-        memory = new Memory(0x3200);
+        memory = new Memory(MEMORY_SIZE);
+    }
+
+    ~Lcd() override
+    {
+        delete memory;
     }
     
     void Transmit(Ssu* ssu) override;
     void TransmitAndReceive(Ssu* ssu) override;
     void Tick() override;
+
+    // nothing changed on screen since the last draw, a frame now would be the same as the one before
+    bool IsIdle() const { return !isDirty; }
+
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
     
     static bool IsDataMode(Ssu* ssu);
 
@@ -45,13 +56,19 @@ public:
     size_t page = 0;
     uint8_t contrast = 20;
     uint8_t pageOffset;
-    bool powerSaveMode;
+    bool powerSaveMode = false;
+
+    // anything that changes the next frame, data written in power save mode doesn't since the screen is blank
+    bool isDirty = true;
 
     static constexpr uint8_t WIDTH = 96;
     static constexpr uint8_t HEIGHT = 64;
     static constexpr uint8_t COLUMN_SIZE = 2;
     
     static constexpr uint8_t TOTAL_COLUMNS = 0xFF;
+
+    // display ram, two bytes per column on every page
+    static constexpr size_t MEMORY_SIZE = 0x3200;
     
     static constexpr std::array<uint32_t, 4> PALETTE = {0xCCCCCC, 0x999999, 0x666666, 0x333333};
     
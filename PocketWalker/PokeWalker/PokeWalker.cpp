@@ -1,6 +1,7 @@
 #include "PokeWalker.h"
 
 #include "../H8/Ssu/Ssu.h"
+#include "../Utilities/StateStream.h"
 
 PokeWalker::PokeWalker(uint8_t* ramBuffer, uint8_t* eepromBuffer) : H8300H(ramBuffer)
 {
@@ -8,6 +9,7 @@ PokeWalker::PokeWalker(uint8_t* ramBuffer, uint8_t* eepromBuffer) : H8300H(ramBu
 
     eeprom = new Eeprom(eepromBuffer);
     RegisterIOComponent(eeprom, Ssu::PORT_1, Ssu::PIN_2);
+    eepromHle = new EepromHle(board->cpu, hle, board->ssu, eeprom);
 
     accelerometer = new Accelerometer();
     RegisterIOComponent(accelerometer, Ssu::PORT_9, Ssu::PIN_0);
@@ -22,25 +24,43 @@ PokeWalker::PokeWalker(uint8_t* ramBuffer, uint8_t* eepromBuffer) : H8300H(ramBu
     RegisterIOComponent(beeper, Ssu::PORT_8, Ssu::PIN_2);
 
     // TODO input only components
-    // TODO remove explicit portB ref
     // TODO use proper pins for each button instead of generalizing, placeholder for now
-    buttons = new Buttons(board->ssu->portB);
+    buttons = new Buttons(board->ram);
     RegisterIOComponent(buttons, Ssu::PORT_B, Ssu::PIN_0);
-}
-
-void PokeWalker::Tick(uint64_t cycles)
-{
-    H8300H::Tick(cycles);
 
-    if (cycles % (Cpu::TICKS / Lcd::TICKS) == 0)
+    board->scheduler->Schedule(Cpu::TICKS / Lcd::TICKS, [this]
     {
         lcd->Tick();
-    }
+    }, [this]
+    {
+        return lcd->IsIdle();
+    });
     
-    if (cycles % (Cpu::TICKS / Beeper::TICKS) == 0)
+    board->scheduler->Schedule(Cpu::TICKS / Beeper::TICKS, [this]
     {
         beeper->Tick();
-    }
+    }, [this]
+    {
+        return beeper->IsIdle();
+    });
+}
+
+PokeWalker::PokeWalker(CopyOnWriteView ram, CopyOnWriteView eeprom) : PokeWalker(ram.GetData(), eeprom.GetData())
+{
+    forkedRam = std::move(ram);
+    forkedEeprom = std::move(eeprom);
+}
+
+PokeWalker::~PokeWalker()
+{
+    Shutdown();
+
+    delete buttons;
+    delete beeper;
+    delete lcd;
+    delete accelerometer;
+    delete eepromHle;
+    delete eeprom;
 }
 
 void PokeWalker::OnDraw(const EventHandlerCallback<LcdInformation>& handler) const
@@ -83,6 +103,59 @@ uint8_t* PokeWalker::GetEepromBuffer() const
     return eeprom->memory->buffer;
 }
 
+bool PokeWalker::AttachEepromRoutines(const EepromRoutines& routines) const
+{
+    return eepromHle->Attach(routines);
+}
+
+std::unique_ptr<PokeWalker> PokeWalker::Fork()
+{
+    const uint8_t* ram = board->ram->buffer;
+    const uint8_t* eepromBuffer = eeprom->memory->buffer;
+
+    if (forkImage == nullptr || !forkImage->ram.Matches(ram) || !forkImage->eeprom.Matches(eepromBuffer))
+    {
+        forkImage = std::make_unique<ForkImage>(ram, eepromBuffer);
+    }
+
+    // loading only writes what differs from the image, which is nothing for ram and eeprom
+    auto fork = std::unique_ptr<PokeWalker>(new PokeWalker(forkImage->ram.Map(), forkImage->eeprom.Map()));
+    fork->LoadState(SaveState());
+    fork->CopySettings(*this);
+
+    return fork;
+}
+
+void PokeWalker::SaveDevices(StateWriter& state) const
+{
+    state.BeginSection(StateTag("EEPR"));
+    eeprom->SaveState(state);
+    state.EndSection();
+
+    state.BeginSection(StateTag("LCD "));
+    lcd->SaveState(state);
+    state.EndSection();
+
+    state.BeginSection(StateTag("ACCL"));
+    accelerometer->SaveState(state);
+    state.EndSection();
+}
+
+void PokeWalker::LoadDevices(StateReader& state)
+{
+    state.OpenSection(StateTag("EEPR"));
+    eeprom->LoadState(state);
+    state.CloseSection();
+
+    state.OpenSection(StateTag("LCD "));
+    lcd->LoadState(state);
+    state.CloseSection();
+
+    state.OpenSection(StateTag("ACCL"));
+    accelerometer->LoadState(state);
+    state.CloseSection();
+}
+
 void PokeWalker::SetupAddressHandlers() const
 {
     // add watts
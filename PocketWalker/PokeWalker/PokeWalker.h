@@ -1,17 +1,20 @@
 #pragma once
+#include <memory>
+
 #include "../H8/H8300H.h"
+#include "../H8/Memory/CopyOnWriteImage.h"
 
 #include "IO/Accelerometer/Accelerometer.h"
 #include "IO/Beeper/Beeper.h"
 #include "IO/Eeprom/Eeprom.h"
+#include "Hle/EepromHle.h"
 
 class PokeWalker : public H8300H
 {
 public:
     PokeWalker(uint8_t* ramBuffer, uint8_t* eepromBuffer);
+    ~PokeWalker() override;
 
-    void Tick(uint64_t cycles) override;
-    
     void OnDraw(const EventHandlerCallback<LcdInformation>& handler) const;
     void OnAudio(const EventHandlerCallback<AudioInformation>& handler) const;
 
@@ -24,10 +27,40 @@ public:
     uint8_t* GetEepromBuffer() const;
     void SetEepromBuffer(uint8_t* buffer) const;
 
+    // only attaches if the routines were taken from the loaded rom
+    bool AttachEepromRoutines(const EepromRoutines& routines) const;
+
+    // a stopped copy of this walker as it is right now, ram and eeprom are shared copy-on-write with every other fork
+    // taken while they're unchanged, hooks, handlers and attached routines are left for the caller to add again
+    std::unique_ptr<PokeWalker> Fork();
+
+protected:
+    void SaveDevices(StateWriter& state) const override;
+    void LoadDevices(StateReader& state) override;
+
 private:
+    // the buffers of a fork, owned by it since nobody else knows about them
+    PokeWalker(CopyOnWriteView ram, CopyOnWriteView eeprom);
+
     void SetupAddressHandlers() const;
+
+    struct ForkImage
+    {
+        ForkImage(const uint8_t* ramBuffer, const uint8_t* eepromBuffer) :
+            ram(ramBuffer, Board::RAM_SIZE), eeprom(eepromBuffer, Eeprom::SIZE) {}
+
+        CopyOnWriteImage ram;
+        CopyOnWriteImage eeprom;
+    };
+
+    // what the last fork was taken from, reused while ram and eeprom still match it
+    std::unique_ptr<ForkImage> forkImage;
+
+    CopyOnWriteView forkedRam;
+    CopyOnWriteView forkedEeprom;
     
     Eeprom* eeprom;
+    EepromHle* eepromHle;
     Accelerometer* accelerometer;
     Lcd* lcd;
     
@@ -0,0 +1,158 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// four characters packed into a section tag, readable in a hex dump
+constexpr uint32_t StateTag(const char (&name)[5])
+{
+    return static_cast<uint8_t>(name[0]) | static_cast<uint8_t>(name[1]) << 8 | static_cast<uint8_t>(name[2]) << 16 | static_cast<uint32_t>(static_cast<uint8_t>(name[3])) << 24;
+}
+
+// a save state is a header followed by sections of a tag, a byte length and the payload, values are copied
+// as they sit in host memory so a state only loads on a host with the same byte order
+class StateWriter
+{
+public:
+    void Reserve(const size_t size)
+    {
+        buffer.reserve(size);
+    }
+
+    template<typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        WriteBytes(&value, sizeof(T));
+    }
+
+    void WriteBytes(const void* data, const size_t size)
+    {
+        const size_t position = buffer.size();
+        buffer.resize(position + size);
+        std::memcpy(buffer.data() + position, data, size);
+    }
+
+    void BeginSection(const uint32_t tag)
+    {
+        Write(tag);
+        sectionStart = buffer.size();
+        Write<uint32_t>(0);
+    }
+
+    void EndSection()
+    {
+        const uint32_t length = static_cast<uint32_t>(buffer.size() - sectionStart - sizeof(uint32_t));
+        std::memcpy(buffer.data() + sectionStart, &length, sizeof(length));
+    }
+
+    std::vector<uint8_t> Take()
+    {
+        return std::move(buffer);
+    }
+
+private:
+    std::vector<uint8_t> buffer;
+    size_t sectionStart = 0;
+};
+
+class StateReader
+{
+public:
+    StateReader(const std::span<const uint8_t> data) : data(data), end(data.size())
+    {
+
+    }
+
+    template<typename T>
+    void Read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        ReadBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    T Read()
+    {
+        T value;
+        Read(value);
+        return value;
+    }
+
+    void ReadBytes(void* destination, const size_t size)
+    {
+        if (size > end - position)
+            throw std::runtime_error("Save state is truncated.");
+
+        std::memcpy(destination, data.data() + position, size);
+        position += size;
+    }
+
+    // only writes the chunks that differ, so pages of a copy-on-write buffer that already match stay shared
+    void ReadChangedBytes(uint8_t* destination, const size_t size)
+    {
+        const uint8_t* source = Peek(size);
+        for (size_t chunk = 0; chunk < size; chunk += CHANGE_CHUNK)
+        {
+            const size_t length = std::min(CHANGE_CHUNK, size - chunk);
+            if (std::memcmp(destination + chunk, source + chunk, length) != 0)
+            {
+                std::memcpy(destination + chunk, source + chunk, length);
+            }
+        }
+
+        position += size;
+    }
+
+    static constexpr size_t CHANGE_CHUNK = 256;
+
+    // the next bytes without reading past them
+    const uint8_t* Peek(const size_t size) const
+    {
+        if (size > end - position)
+            throw std::runtime_error("Save state is truncated.");
+
+        return data.data() + position;
+    }
+
+    // sections are read in the order they were written, ones in between that this build doesn't know are skipped
+    void OpenSection(const uint32_t tag)
+    {
+        end = data.size();
+        while (true)
+        {
+            if (end - position < sizeof(uint32_t) * 2)
+                throw std::runtime_error("Save state is missing a section.");
+
+            const uint32_t sectionTag = Read<uint32_t>();
+            const uint32_t length = Read<uint32_t>();
+            if (length > end - position)
+                throw std::runtime_error("Save state is truncated.");
+
+            if (sectionTag == tag)
+            {
+                end = position + length;
+                return;
+            }
+
+            position += length;
+        }
+    }
+
+    void CloseSection()
+    {
+        if (position != end)
+            throw std::runtime_error("Save state section doesn't match its length.");
+
+        end = data.size();
+    }
+
+private:
+    std::span<const uint8_t> data;
+    size_t position = 0;
+    size_t end;
+};